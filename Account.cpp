@@ -1,13 +1,49 @@
 #include "Account.h"
 #include "BankFunds.h"
+#include "Metrics.h"
 #include "Validators.h"
 #include "Storage.h"
+#include "Trace.h"
+#include <algorithm>
 #include <iomanip>
 #include <ctime>
+#include <limits>
 #include <sstream>
+#include <type_traits>
 
 namespace bankSimulation {
 
+    namespace {
+
+        /**
+         * @brief Prompts until a date in YYYY-MM-DD form is entered.
+         *
+         * @param prompt Message displayed to the user.
+         * @param timeOfDay Time appended to the date, as HH:MM:SS.
+         * @return That time on the entered date, in seconds since the epoch.
+         */
+        std::int64_t promptDate(const std::string& prompt, const char* timeOfDay) {
+            std::int64_t when = 0;
+            while (when == 0) {
+                when = Account::parseTimestamp(stringValidator(prompt) + " " + timeOfDay);
+                if (when == 0) {
+                    std::cout << "Enter the date as YYYY-MM-DD." << std::endl;
+                }
+            }
+            return when;
+        }
+    }
+
+    // Storage keeps accounts in a std::vector, which only moves them on reallocation if
+    // the move cannot throw; otherwise every account and its history would be copied.
+    static_assert(std::is_nothrow_move_constructible<Account>::value, "Account must be cheaply movable");
+
+    /**
+     * @brief Creates an empty account whose history is allocated from the given resource.
+     * @param historyResource Resource that must outlive the account's history.
+     */
+    Account::Account(std::pmr::memory_resource* historyResource) : transactionHistory(historyResource) {}
+
     // === Mutators ===
 
     /**
@@ -16,6 +52,7 @@ namespace bankSimulation {
      */
     void Account::setHolderFirstName(const std::string& entry) {
         holderFistName = entry;
+        recordDirty = true;
     }
 
     /**
@@ -24,6 +61,16 @@ namespace bankSimulation {
      */
     void Account::setHolderLastName(const std::string& entry) {
         holderLastName = entry;
+        lastNameId = NameTable::noName;
+        recordDirty = true;
+    }
+
+    /**
+     * @brief Records the interned id of the last name.
+     * @param id Id assigned by the Storage name table.
+     */
+    void Account::setLastNameId(NameTable::NameId id) {
+        lastNameId = id;
     }
 
     /**
@@ -32,6 +79,7 @@ namespace bankSimulation {
      */
     void Account::setHolderAccountNumber(const unsigned& entry) {
         holderAccountNumber = entry;
+        recordDirty = true;
     }
 
     /**
@@ -40,6 +88,7 @@ namespace bankSimulation {
      */
     void Account::setHolderPassword(const std::string& entry) {
         holderPassword = entry;
+        recordDirty = true;
     }
 
     /**
@@ -48,26 +97,35 @@ namespace bankSimulation {
      */
     void Account::setBalance(const double& entry) {
         balance = entry;
+        recordDirty = true;
     }
 
     // === Accessors ===
 
     /**
      * @brief Retrieves the first name of the account holder.
-     * @return First name as a string.
+     * @return First name, without copying it.
      */
-    std::string Account::getHolderFirstName() const {
+    std::string_view Account::getHolderFirstName() const {
         return holderFistName;
     }
 
     /**
      * @brief Retrieves the last name of the account holder.
-     * @return Last name as a string.
+     * @return Last name, without copying it.
      */
-    std::string Account::getHolderLastName() const {
+    std::string_view Account::getHolderLastName() const {
         return holderLastName;
     }
 
+    /**
+     * @brief Gets the interned id of the last name.
+     * @return Last name id.
+     */
+    NameTable::NameId Account::getLastNameId() const {
+        return lastNameId;
+    }
+
     /**
      * @brief Gets the unique account number.
      * @return Account number.
@@ -78,9 +136,9 @@ namespace bankSimulation {
 
     /**
      * @brief Retrieves the account password.
-     * @return Password string.
+     * @return Password, without copying it.
      */
-    std::string Account::getHolderPassword() const {
+    std::string_view Account::getHolderPassword() const {
         return holderPassword;
     }
 
@@ -92,36 +150,98 @@ namespace bankSimulation {
         return balance;
     }
 
+    /**
+     * @brief Gets the number of transactions currently stored.
+     * @return Transaction count.
+     */
+    int Account::getTransactionCount() const {
+        return transactionCount;
+    }
+
+    /**
+     * @brief Maps a chronological position onto its slot in the circular history buffer.
+     * @param index 0 for the oldest stored transaction.
+     * @return Reference to the stored transaction.
+     */
+    const Account::Transaction& Account::getTransaction(int index) const {
+        return transactionHistory[(transactionHead + index) % maxTransactions];
+    }
+
+    /**
+     * @brief Finds the first stored transaction at or after a time by binary search.
+     *
+     * Searches chronological positions rather than buffer slots, so the wrap of the
+     * circular buffer needs no special handling.
+     *
+     * @param time Seconds since the epoch.
+     * @return Chronological position, or getTransactionCount() if every transaction is older.
+     */
+    int Account::findTransactionAt(std::int64_t time) const {
+        int low = 0;
+        int high = transactionCount;
+        while (low < high) {
+            int middle = low + (high - low) / 2;
+            if (getTransaction(middle).timestamp < time) {
+                low = middle + 1;
+            }
+            else {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    /**
+     * @brief Gets the stored transactions within a time range from two binary searches.
+     *
+     * @param from Earliest time, inclusive.
+     * @param to Latest time, inclusive.
+     * @return Positions of the matching transactions.
+     */
+    Account::TransactionRange Account::transactionsBetween(std::int64_t from, std::int64_t to) const {
+        if (to < from) {
+            return { 0, 0 };
+        }
+
+        int first = findTransactionAt(from);
+        int last = to == std::numeric_limits<std::int64_t>::max() ? transactionCount : findTransactionAt(to + 1);
+        return { first, last };
+    }
+
+    /**
+     * @brief Gets the most recent stored transactions.
+     * @param count Most transactions to include.
+     * @return Positions of up to count of the newest transactions.
+     */
+    Account::TransactionRange Account::lastTransactions(int count) const {
+        int first = count < transactionCount ? transactionCount - std::max(count, 0) : 0;
+        return { first, transactionCount };
+    }
+
     // === Transaction Functions ===
 
     /**
      * @brief Withdraws funds from the account and updates bank-wide totals.
      *
-     * Prompts the user to enter a withdrawal amount within a valid range. Checks if
-     * sufficient funds are available; if so, reduces the account balance, logs the transaction,
-     * and updates the bank's total withdrawals and holdings accordingly.
+     * Prompts the user to enter a withdrawal amount within a valid range, applies it
+     * through applyWithdrawal, and reports the outcome.
      *
      * @param bank Reference to the BankFunds object to update global totals.
      * @param storage Reference to the Storage object used for persisting data.
      */
     void Account::withdrawal(BankFunds& bank, Storage& storage) {
-        double amount = numericValidator("Enter withdrawal amount: ", 0.01, 5000.00);
+        double amount = numericValidator("Enter withdrawal amount: ", minTransactionAmount, maxTransactionAmount);
 
-        if (amount > balance) {
+        if (amount <= balance && transactionCount >= maxTransactions) {
+            std::cout << "Transaction log full. Oldest entry will be overwritten." << std::endl;
+        }
+
+        if (applyWithdrawal(amount, bank, storage) == TransactionResult::InsufficientFunds) {
             std::cout << "Insufficient funds. ";
             printAccountBalance();
             return;
         }
 
-        balance -= amount;
-        logTransaction("Withdrawal", amount, balance, storage);
-
-        double updatedWithdrawals = bank.getTotalWithdrawals() + amount;
-        bank.setTotalWithdrawals(updatedWithdrawals);
-
-        double updatedHoldings = bank.getTotalHoldings() - amount;
-        bank.setTotalHoldings(updatedHoldings);
-
         std::cout << "Withdrawal successful. ";
         printAccountBalance();
     }
@@ -129,68 +249,353 @@ namespace bankSimulation {
     /**
      * @brief Deposits funds into the account and updates bank-wide totals.
      *
-     * Prompts the user to enter a deposit amount within a valid range. Increases the account balance,
-     * logs the transaction, and updates the bank's total deposits and holdings accordingly.
+     * Prompts the user to enter a deposit amount within a valid range, applies it
+     * through applyDeposit, and reports the new balance.
      *
      * @param bank Reference to the BankFunds object to update global totals.
      * @param storage Reference to the Storage object used for persisting data.
      */
     void Account::deposit(BankFunds& bank, Storage& storage) {
-        double amount = numericValidator("Enter deposit amount: ", 0.01, 5000.00);
-
-        balance += amount;
-        logTransaction("Deposit", amount, balance, storage);
+        double amount = numericValidator("Enter deposit amount: ", minTransactionAmount, maxTransactionAmount);
 
-        double updatedDeposits = bank.getTotalDeposits() + amount;
-        bank.setTotalDeposits(updatedDeposits);
+        if (transactionCount >= maxTransactions) {
+            std::cout << "Transaction log full. Oldest entry will be overwritten." << std::endl;
+        }
 
-        double updatedHoldings = bank.getTotalHoldings() + amount;
-        bank.setTotalHoldings(updatedHoldings);
+        applyDeposit(amount, bank, storage);
 
         std::cout << "Deposit successful. ";
         printAccountBalance();
     }
 
+    /**
+     * @brief Applies a withdrawal without any console interaction.
+     *
+     * Checks the amount and available funds; if both are fine, reduces the account
+     * balance, updates the bank's total withdrawals and holdings, and logs the transaction.
+     * Holds the storage's transaction lock throughout, so a background checkpoint never
+     * captures the account and the bank totals halfway through.
+     *
+     * @param amount Amount to withdraw.
+     * @param bank Reference to the BankFunds object to update global totals.
+     * @param storage Reference to the Storage object used for persisting data.
+     * @return Outcome of the withdrawal.
+     */
+    Account::TransactionResult Account::applyWithdrawal(double amount, BankFunds& bank, Storage& storage) {
+        ScopedTimer timer(Metric::Withdrawal);
+        auto state = storage.lockForTransaction();
+
+        if (!(amount >= minTransactionAmount && amount <= maxTransactionAmount)) {
+            metrics::increment(Counter::InvalidAmounts);
+            return TransactionResult::InvalidAmount;
+        }
+
+        if (amount > balance) {
+            metrics::increment(Counter::InsufficientFunds);
+            return TransactionResult::InsufficientFunds;
+        }
+
+        balance -= amount;
+
+        // One time for both, so the live volume bucket is the one a journal replay rebuilds
+        std::time_t now = std::time(nullptr);
+        bank.recordWithdrawal(amount, static_cast<std::int64_t>(now));
+
+        logTransaction(TransactionType::Withdrawal, amount, balance, storage, now);
+        metrics::increment(Counter::WithdrawalsApplied);
+        return TransactionResult::Applied;
+    }
+
+    /**
+     * @brief Applies a deposit without any console interaction.
+     *
+     * Checks the amount; if it is valid, increases the account balance, updates the
+     * bank's total deposits and holdings, and logs the transaction under the storage's
+     * transaction lock.
+     *
+     * @param amount Amount to deposit.
+     * @param bank Reference to the BankFunds object to update global totals.
+     * @param storage Reference to the Storage object used for persisting data.
+     * @return Outcome of the deposit.
+     */
+    Account::TransactionResult Account::applyDeposit(double amount, BankFunds& bank, Storage& storage) {
+        ScopedTimer timer(Metric::Deposit);
+        auto state = storage.lockForTransaction();
+
+        if (!(amount >= minTransactionAmount && amount <= maxTransactionAmount)) {
+            metrics::increment(Counter::InvalidAmounts);
+            return TransactionResult::InvalidAmount;
+        }
+
+        balance += amount;
+
+        std::time_t now = std::time(nullptr);
+        bank.recordDeposit(amount, static_cast<std::int64_t>(now));
+
+        logTransaction(TransactionType::Deposit, amount, balance, storage, now);
+        metrics::increment(Counter::DepositsApplied);
+        return TransactionResult::Applied;
+    }
+
     /**
      * @brief Records a financial transaction in the accounts history.
      *
-     * Maintains a fixed-size log of the most recent transactions, recording type,
-     * amount, resulting balance, and a timestamp. If the log is full, it discards
-     * the oldest entry to make room for new transactions.
+     * Adds the transaction to the in-memory history and appends one record to the
+     * storage journal. The caller must have already applied the transaction to the
+     * account and bank totals, since the journal may trigger a checkpoint.
      *
-     * Saves the updated account and bank data after logging.
+     * @param type Type of transaction.
+     * @param amount Amount of the transaction.
+     * @param resultingBalance Account balance after the transaction.
+     * @param storage Reference to the Storage object to save changes.
+     */
+    void Account::logTransaction(TransactionType type, double amount, double resultingBalance, Storage& storage) {
+        logTransaction(type, amount, resultingBalance, storage, std::time(nullptr));
+    }
+
+    /**
+     * @brief Records a financial transaction that happened at a given time.
      *
-     * @param type Type of transaction (e.g., "Deposit", "Withdrawal").
+     * @param type Type of transaction.
      * @param amount Amount of the transaction.
      * @param resultingBalance Account balance after the transaction.
      * @param storage Reference to the Storage object to save changes.
+     * @param when Time the transaction happened, as already recorded in the bank totals.
      */
-    void Account::logTransaction(const std::string& type, double amount, double resultingBalance, Storage& storage) {
-        if (transactionCount >= maxTransactions) {
-            std::cout << "Transaction log full. Oldest entry will be overwritten." << std::endl;
-            for (int i = 1; i < maxTransactions; ++i) {
-                transactionHistory[i - 1] = transactionHistory[i];
-            }
-            transactionCount = maxTransactions - 1;
-        }
+    void Account::logTransaction(TransactionType type, double amount, double resultingBalance, Storage& storage, std::time_t when) {
+        ScopedTimer timer(Metric::LogTransaction);
+        storage.loadHistory(*this, true);
+        recordTransaction(type, amount, resultingBalance, when);
+        storage.updateQueryIndex(*this, when, type == TransactionType::Withdrawal ? amount : 0.0);
+        storage.journalTransaction(holderAccountNumber, type, amount, resultingBalance, when);
+    }
 
-        Transaction t;
-        t.type = type;
+    /**
+     * @brief Adds a transaction to the in-memory history.
+     *
+     * Maintains a fixed-size circular log of the most recent transactions, recording
+     * type, amount, resulting balance, and a timestamp. If the log is full, the new
+     * entry overwrites the oldest one and the head advances, so nothing is shifted.
+     *
+     * @param type Type of transaction.
+     * @param amount Amount of the transaction.
+     * @param resultingBalance Account balance after the transaction.
+     * @param when Time the transaction happened.
+     */
+    void Account::recordTransaction(TransactionType type, double amount, double resultingBalance, std::time_t when) {
+        Transaction& t = nextHistorySlot();
+        t.timestamp = static_cast<std::int64_t>(when);
         t.amount = amount;
         t.resultingBalance = resultingBalance;
+        t.type = type;
+    }
+
+    // === Transaction Formatting ===
+
+    /**
+     * @brief Gets the display name of a transaction type.
+     * @param type Transaction type.
+     * @return "Deposit" or "Withdrawal".
+     */
+    const char* Account::typeName(TransactionType type) {
+        return type == TransactionType::Deposit ? "Deposit" : "Withdrawal";
+    }
+
+    /**
+     * @brief Parses a display name written by older versions of the program.
+     * @param name "Deposit" or "Withdrawal".
+     * @return Matching type.
+     */
+    Account::TransactionType Account::parseTypeName(const std::string& name) {
+        return name == "Deposit" ? TransactionType::Deposit : TransactionType::Withdrawal;
+    }
 
-        auto now = std::time(nullptr);
+    /**
+     * @brief Formats a timestamp as local time.
+     * @param timestamp Seconds since the epoch.
+     * @return Time as "YYYY-MM-DD HH:MM:SS".
+     */
+    std::string Account::formatTimestamp(std::int64_t timestamp) {
+        std::time_t when = static_cast<std::time_t>(timestamp);
         std::tm timeInfo;
-        localtime_s(&timeInfo, &now);
+        localtime_s(&timeInfo, &when);
 
         std::stringstream ss;
         ss << std::put_time(&timeInfo, "%Y-%m-%d %H:%M:%S");
-        t.timestamp = ss.str();
+        return ss.str();
+    }
 
-        transactionHistory[transactionCount++] = t;
+    /**
+     * @brief Parses a local time in the format written by formatTimestamp.
+     *
+     * Used for histories saved before timestamps were stored as numbers.
+     *
+     * @param text Time as "YYYY-MM-DD HH:MM:SS".
+     * @return Seconds since the epoch, or 0 if the text cannot be parsed.
+     */
+    std::int64_t Account::parseTimestamp(const std::string& text) {
+        std::tm timeInfo = {};
+        std::istringstream ss(text);
+        ss >> std::get_time(&timeInfo, "%Y-%m-%d %H:%M:%S");
+        if (ss.fail()) {
+            return 0;
+        }
 
-        storage.saveAccount();
-        storage.saveBank();
+        timeInfo.tm_isdst = -1;
+        std::time_t when = std::mktime(&timeInfo);
+        return when == static_cast<std::time_t>(-1) ? 0 : static_cast<std::int64_t>(when);
+    }
+
+    /**
+     * @brief Claims the history slot for a new transaction and marks the history and record dirty.
+     *
+     * Grows the buffer while the history has room, so the head stays at slot 0 until it
+     * is full; after that, reuses the oldest slot and advances the head.
+     *
+     * @return Reference to the slot to fill in.
+     */
+    Account::Transaction& Account::nextHistorySlot() {
+        historyDirty = true;
+        recordDirty = true;
+
+        if (transactionCount >= maxTransactions) {
+            Transaction& slot = transactionHistory[transactionHead];
+            transactionHead = (transactionHead + 1) % maxTransactions;
+            return slot;
+        }
+
+        transactionHistory.emplace_back();
+        ++transactionCount;
+        return transactionHistory.back();
+    }
+
+    // === History Residency ===
+
+    /**
+     * @brief Checks whether the transaction history is in memory.
+     * @return True if loaded.
+     */
+    bool Account::isHistoryLoaded() const {
+        return historyLoaded;
+    }
+
+    /**
+     * @brief Checks whether the history changed since it was last stored.
+     * @return True if dirty.
+     */
+    bool Account::isHistoryDirty() const {
+        return historyDirty;
+    }
+
+    /**
+     * @brief Checks whether the stored record is out of date.
+     *
+     * A changed history always changes the record too, through its count and balance.
+     *
+     * @return True if dirty.
+     */
+    bool Account::isRecordDirty() const {
+        return recordDirty || historyDirty;
+    }
+
+    /**
+     * @brief Records that the account's record has been written.
+     */
+    void Account::markRecordStored() {
+        recordDirty = false;
+    }
+
+    /**
+     * @brief Checks whether anything changed since markRecordStored, ignoring the history flag.
+     * @return True if a field or the history changed since.
+     */
+    bool Account::isRecordModified() const {
+        return recordDirty;
+    }
+
+    /**
+     * @brief Marks the record as out of date again after a write that did not complete.
+     */
+    void Account::markRecordDirty() {
+        recordDirty = true;
+    }
+
+    /**
+     * @brief Gets the location of the stored history in accounts.dat.
+     * @return Stored history offset.
+     */
+    std::uint64_t Account::getHistoryOffset() const {
+        return historyOffset;
+    }
+
+    /**
+     * @brief Records where the history is stored without loading it.
+     * @param offset Location of the stored history.
+     * @param count Number of stored transactions.
+     */
+    void Account::setStoredHistory(std::uint64_t offset, int count) {
+        History(transactionHistory.get_allocator()).swap(transactionHistory);
+        transactionHead = 0;
+        transactionCount = count;
+        historyOffset = offset;
+        historyLoaded = false;
+        historyDirty = false;
+    }
+
+    /**
+     * @brief Marks the history as changed so it is not evicted before it is stored.
+     */
+    void Account::markHistoryDirty() {
+        historyDirty = true;
+    }
+
+    /**
+     * @brief Records that the history now matches what is stored at the given location.
+     * @param offset Location of the stored history.
+     */
+    void Account::markHistoryStored(std::uint64_t offset) {
+        historyOffset = offset;
+        historyDirty = false;
+    }
+
+    /**
+     * @brief Replaces the history with transactions read from storage.
+     * @param history Transactions in chronological order.
+     */
+    void Account::restoreHistory(History&& history) {
+        transactionHistory = std::move(history);
+        transactionHead = 0;
+        transactionCount = static_cast<int>(transactionHistory.size());
+        historyLoaded = true;
+        historyDirty = false;
+    }
+
+    /**
+     * @brief Frees the in-memory history, keeping the stored count and location.
+     */
+    void Account::releaseHistory() {
+        History(transactionHistory.get_allocator()).swap(transactionHistory);
+        transactionHead = 0;
+        historyLoaded = false;
+    }
+
+    /**
+     * @brief Estimates the heap memory held by the in-memory history.
+     *
+     * Transactions hold no heap data of their own, so this is just the buffer.
+     *
+     * @return Approximate size in bytes.
+     */
+    std::size_t Account::getHistoryMemory() const {
+        return transactionHistory.capacity() * sizeof(Transaction);
+    }
+
+    /**
+     * @brief Gets the memory resource the history is allocated from.
+     * @return History resource.
+     */
+    std::pmr::memory_resource* Account::getHistoryResource() const {
+        return transactionHistory.get_allocator().resource();
     }
 
     // === Serialization ===
@@ -199,7 +604,9 @@ namespace bankSimulation {
      * @brief Serializes account data and writes it to a binary output stream.
      *
      * Stores personal info, balance, and transaction history in binary format
-     * for persistent storage.
+     * for persistent storage. Only the live history entries are written, oldest first.
+     * This is the version 1 layout, so each transaction's type and timestamp are
+     * written out as text.
      *
      * @param out Output stream to write the serialized data.
      */
@@ -228,23 +635,25 @@ namespace bankSimulation {
         // Write transaction count
         out.write(reinterpret_cast<const char*>(&transactionCount), sizeof(transactionCount));
 
-        // Write each transaction
+        // Write each transaction in chronological order
         for (int i = 0; i < transactionCount; ++i) {
-            const Transaction& t = transactionHistory[i];
+            const Transaction& t = getTransaction(i);
 
             // Type
-            len = t.type.size();
+            std::string type = typeName(t.type);
+            len = type.size();
             out.write(reinterpret_cast<const char*>(&len), sizeof(len));
-            out.write(t.type.c_str(), len);
+            out.write(type.c_str(), len);
 
             // Amount and postBalance
             out.write(reinterpret_cast<const char*>(&t.amount), sizeof(t.amount));
             out.write(reinterpret_cast<const char*>(&t.resultingBalance), sizeof(t.resultingBalance));
 
             // Timestamp
-            len = t.timestamp.size();
+            std::string timestamp = formatTimestamp(t.timestamp);
+            len = timestamp.size();
             out.write(reinterpret_cast<const char*>(&len), sizeof(len));
-            out.write(t.timestamp.c_str(), len);
+            out.write(timestamp.c_str(), len);
         }
     }
 
@@ -252,10 +661,13 @@ namespace bankSimulation {
      * @brief Deserializes account data by reading from a binary input stream.
      *
      * Restores personal info, account balance, and transaction history from persisted storage.
+     * The history is stored oldest first, so it is read back with the head at slot 0.
+     * Only used for version 1 files, so the history is marked dirty until it is saved.
      *
      * @param in Input stream to read the serialized data.
      */
     void Account::deserialize(std::istream& in) {
+        TraceScope trace("deserialize", "startup");
         size_t len;
 
         // First Name
@@ -280,16 +692,21 @@ namespace bankSimulation {
         in.read(reinterpret_cast<char*>(&balance), sizeof(balance));
 
         // Read transaction count
-        in.read(reinterpret_cast<char*>(&transactionCount), sizeof(transactionCount));
+        int storedCount = 0;
+        in.read(reinterpret_cast<char*>(&storedCount), sizeof(storedCount));
 
-        // Read each transaction
-        for (int i = 0; i < transactionCount; ++i) {
-            Transaction& t = transactionHistory[i];
+        History history(static_cast<std::size_t>(storedCount), getHistoryResource());
+        std::string text;
+
+        // Read each transaction, parsing the text fields of the version 1 layout
+        for (int i = 0; i < storedCount; ++i) {
+            Transaction& t = history[i];
 
             // Type
             in.read(reinterpret_cast<char*>(&len), sizeof(len));
-            t.type.resize(len);
-            in.read(&t.type[0], len);
+            text.resize(len);
+            in.read(&text[0], len);
+            t.type = parseTypeName(text);
 
             // Amount and postBalance
             in.read(reinterpret_cast<char*>(&t.amount), sizeof(t.amount));
@@ -297,9 +714,14 @@ namespace bankSimulation {
 
             // Timestamp
             in.read(reinterpret_cast<char*>(&len), sizeof(len));
-            t.timestamp.resize(len);
-            in.read(&t.timestamp[0], len);
+            text.resize(len);
+            in.read(&text[0], len);
+            t.timestamp = parseTimestamp(text);
         }
+
+        // A version 1 history has no location in the current file layout until it is saved
+        restoreHistory(std::move(history));
+        historyDirty = true;
     }
 
     // === Display Functions ===
@@ -314,17 +736,68 @@ namespace bankSimulation {
 
     /**
      * @brief Prints a detailed transaction history including timestamps and balances.
+     *
+     * Timestamps are formatted here rather than when the transaction is recorded.
      */
     void Account::printAccountHistory() const {
         std::cout << std::fixed << std::setprecision(2);
         std::cout << "Account #" << this->getHolderAccountNumber() << std::endl;
         std::cout << "Transaction History:" << std::endl;
-        for (int i = 0; i < transactionCount; ++i) {
-            const auto& t = transactionHistory[i];
-            std::cout << t.timestamp << " | "
-                << t.type << " | "
+        if (!historyLoaded) {
+            std::cout << "(" << transactionCount << " transactions not loaded)" << std::endl;
+            return;
+        }
+        printTransactions({ 0, transactionCount });
+    }
+
+    /**
+     * @brief Prints a run of stored transactions, one line each, oldest first.
+     *
+     * Only the transactions in the range are formatted.
+     *
+     * @param range Positions to print.
+     */
+    void Account::printTransactions(TransactionRange range) const {
+        std::cout << std::fixed << std::setprecision(2);
+        for (int i = range.first; i < range.last; ++i) {
+            const auto& t = getTransaction(i);
+            std::cout << formatTimestamp(t.timestamp) << " | "
+                << typeName(t.type) << " | "
                 << "$" << t.amount << " | "
                 << "Balance after: $" << t.resultingBalance << std::endl;
         }
     }
+
+    /**
+     * @brief Prompts for a first and last day and prints the transactions made on or between them.
+     */
+    void Account::printHistoryBetween() const {
+        if (!historyLoaded) {
+            std::cout << "(" << transactionCount << " transactions not loaded)" << std::endl;
+            return;
+        }
+
+        std::int64_t from = promptDate("From date (YYYY-MM-DD): ", "00:00:00");
+        std::int64_t to = promptDate("To date (YYYY-MM-DD): ", "23:59:59");
+
+        TransactionRange range = transactionsBetween(from, to);
+        std::cout << "Account #" << holderAccountNumber << std::endl;
+        printTransactions(range);
+        int found = range.last - range.first;
+        std::cout << found << (found == 1 ? " transaction" : " transactions") << " in that period." << std::endl;
+    }
+
+    /**
+     * @brief Prompts for a count and prints that many of the newest transactions, oldest first.
+     */
+    void Account::printRecentHistory() const {
+        if (!historyLoaded) {
+            std::cout << "(" << transactionCount << " transactions not loaded)" << std::endl;
+            return;
+        }
+
+        int count = numericValidator("Number of recent transactions to show: ", 1, maxTransactions);
+        std::cout << "Account #" << holderAccountNumber << std::endl;
+        printTransactions(lastTransactions(count));
+    }
 }
\ No newline at end of file
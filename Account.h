@@ -1,7 +1,12 @@
 #pragma once
+#include <cstdint>
+#include <ctime>
 #include <iostream>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "NameTable.h"
 
 namespace bankSimulation {
 
@@ -12,37 +17,105 @@ namespace bankSimulation {
 	 * @class Account
 	 * @brief Represents a users bank account, including personal details, balance, and transaction history.
 	 *
-	 * This class manages individual account information such as name, password, balance, and a fixed-size
+	 * This class manages individual account information such as name, password, balance, and a bounded
 	 * transaction log. It also supports deposit and withdrawal operations that update the banks central funds.
+	 *
+	 * The log lives in its own buffer sized to the number of stored transactions, so an
+	 * Account is small and moves without copying its history. The buffer comes from the
+	 * memory resource the account was created with, which lets Storage place every
+	 * loaded history in one arena.
 	 */
 	class Account {
-	private:
-		// Biographical Variables
-		std::string holderFistName;              ///< First name of the account holder
-		std::string holderLastName;              ///< Last name of the account holder
-		unsigned holderAccountNumber;            ///< Unique account number
-		std::string holderPassword;              ///< Password for authentication
-		double balance;                          ///< Current account balance
+	public:
+		/**
+		 * @enum TransactionType
+		 * @brief Kind of transaction; the values double as the journal's type codes.
+		 */
+		enum class TransactionType : std::uint8_t {
+			Deposit = 'D',      ///< Money paid into the account
+			Withdrawal = 'W'    ///< Money taken out of the account
+		};
 
 		/**
 		 * @struct Transaction
 		 * @brief Stores details of a single transaction.
 		 *
-		 * Contains the type of transaction, amount, resulting balance, and timestamp.
+		 * Contains the type of transaction, amount, resulting balance, and timestamp. The
+		 * timestamp is kept as seconds since the epoch and only formatted for display or
+		 * export, so recording a transaction neither allocates nor formats.
 		 */
 		struct Transaction {
-			std::string type;
-			double amount;
-			double resultingBalance;
-			std::string timestamp;
+			std::int64_t timestamp;      ///< Seconds since the epoch
+			double amount;               ///< Amount of the transaction
+			double resultingBalance;     ///< Balance after the transaction
+			TransactionType type;        ///< Deposit or withdrawal
+		};
+
+		/// Transaction buffer allocated from the account's memory resource
+		using History = std::pmr::vector<Transaction>;
+
+		/**
+		 * @struct TransactionRange
+		 * @brief Run of stored transactions, as chronological positions [first, last).
+		 */
+		struct TransactionRange {
+			int first;                   ///< Position of the oldest transaction in the run
+			int last;                    ///< One past the position of the newest
+		};
+
+		/**
+		 * @enum TransactionResult
+		 * @brief Outcome of applying a deposit or withdrawal.
+		 */
+		enum class TransactionResult {
+			Applied,            ///< Balance, bank totals, and history were updated
+			InsufficientFunds,  ///< Withdrawal larger than the balance; nothing changed
+			InvalidAmount,      ///< Amount outside the allowed range; nothing changed
+			UnknownAccount      ///< No account with the requested number; nothing changed
 		};
 
+		static constexpr double minTransactionAmount = 0.01;     ///< Smallest allowed deposit or withdrawal
+		static constexpr double maxTransactionAmount = 5'000.00; ///< Largest allowed deposit or withdrawal
+		static const int maxTransactions = 1'000;                ///< Maximum number of stored transactions
+
+	private:
+		// Biographical Variables
+		std::string holderFistName;              ///< First name of the account holder
+		std::string holderLastName;              ///< Last name of the account holder
+		NameTable::NameId lastNameId = NameTable::noName;   ///< Interned last name, assigned when Storage indexes the account
+		unsigned holderAccountNumber;            ///< Unique account number
+		std::string holderPassword;              ///< Password for authentication
+		double balance;                          ///< Current account balance
+
 		// Transaction History
-		static const int maxTransactions = 1'000;           ///< Maximum number of stored transactions
-		Transaction transactionHistory[maxTransactions];    ///< Fixed-size array of past transactions
+		History transactionHistory;                         ///< Circular buffer of past transactions, grown on demand
+		int transactionHead = 0;                            ///< Slot holding the oldest transaction
 		int transactionCount = 0;                           ///< Number of transactions recorded
 
+		// History Residency
+		bool historyLoaded = true;                          ///< Whether transactionHistory holds the history
+		bool historyDirty = false;                          ///< Whether the history changed since it was stored
+		bool recordDirty = true;                            ///< Whether a field of the stored record changed since it was stored
+		std::uint64_t historyOffset = 0;                    ///< Location of the stored history in accounts.dat
+
+		/**
+		 * @brief Claims the history slot for a new transaction, overwriting the oldest if full.
+		 * @return Reference to the slot to fill in.
+		 */
+		Transaction& nextHistorySlot();
+
 	public:
+		/**
+		 * @brief Creates an empty account whose history is allocated from the default memory resource.
+		 */
+		Account() = default;
+
+		/**
+		 * @brief Creates an empty account whose history is allocated from the given memory resource.
+		 * @param historyResource Resource that must outlive the account's history.
+		 */
+		explicit Account(std::pmr::memory_resource* historyResource);
+
 		// Mutators
 
 		/**
@@ -57,6 +130,12 @@ namespace bankSimulation {
 		 */
 		void setHolderLastName(const std::string& entry);
 
+		/**
+		 * @brief Records the interned id of the last name.
+		 * @param id Id assigned by the Storage name table.
+		 */
+		void setLastNameId(NameTable::NameId id);
+
 		/**
 		 * @brief Sets the unique account number.
 		 * @param entry Account number to assign.
@@ -79,15 +158,21 @@ namespace bankSimulation {
 
 		/**
 		 * @brief Gets the first name of the account holder.
-		 * @return First name string.
+		 * @return View of the first name, valid until the name is changed.
 		 */
-		std::string getHolderFirstName() const;
+		std::string_view getHolderFirstName() const;
 
 		/**
 		 * @brief Gets the last name of the account holder.
-		 * @return Last name string.
+		 * @return View of the last name, valid until the name is changed.
+		 */
+		std::string_view getHolderLastName() const;
+
+		/**
+		 * @brief Gets the interned id of the last name.
+		 * @return Id in the Storage name table, or NameTable::noName if the account is not stored.
 		 */
-		std::string getHolderLastName() const;
+		NameTable::NameId getLastNameId() const;
 
 		/**
 		 * @brief Gets the unique account number.
@@ -97,9 +182,9 @@ namespace bankSimulation {
 
 		/**
 		 * @brief Gets the account password.
-		 * @return Password string.
+		 * @return View of the password, valid until the password is changed.
 		 */
-		std::string getHolderPassword() const;
+		std::string_view getHolderPassword() const;
 
 		/**
 		 * @brief Gets the current account balance.
@@ -107,6 +192,49 @@ namespace bankSimulation {
 		 */
 		double getBalance() const;
 
+		/**
+		 * @brief Gets the number of transactions currently stored.
+		 * @return Transaction count.
+		 */
+		int getTransactionCount() const;
+
+		/**
+		 * @brief Gets a transaction by its chronological position.
+		 *
+		 * The history must be loaded; see isHistoryLoaded.
+		 *
+		 * @param index 0 for the oldest stored transaction, getTransactionCount() - 1 for the newest.
+		 * @return Reference to the stored transaction.
+		 */
+		const Transaction& getTransaction(int index) const;
+
+		/**
+		 * @brief Finds the first stored transaction at or after a time.
+		 *
+		 * Binary-searches the history, which recordTransaction keeps in chronological
+		 * order. The history must be loaded; see isHistoryLoaded.
+		 *
+		 * @param time Seconds since the epoch.
+		 * @return Chronological position, or getTransactionCount() if every transaction is older.
+		 */
+		int findTransactionAt(std::int64_t time) const;
+
+		/**
+		 * @brief Gets the stored transactions that happened within a time range.
+		 *
+		 * @param from Earliest time, inclusive.
+		 * @param to Latest time, inclusive.
+		 * @return Positions of the matching transactions; empty if there are none.
+		 */
+		TransactionRange transactionsBetween(std::int64_t from, std::int64_t to) const;
+
+		/**
+		 * @brief Gets the most recent stored transactions.
+		 * @param count Most transactions to include.
+		 * @return Positions of up to count of the newest transactions.
+		 */
+		TransactionRange lastTransactions(int count) const;
+
 		// Transaction Functions
 
 		/**
@@ -130,17 +258,196 @@ namespace bankSimulation {
 		 */
 		void withdrawal(BankFunds& bank, Storage& storage);
 
+		/**
+		 * @brief Applies a deposit of a known amount without prompting.
+		 *
+		 * Shared by the interactive menu and batch ingestion.
+		 *
+		 * @param amount Amount to deposit.
+		 * @param bank Reference to the central BankFunds object.
+		 * @param storage Reference to the data storage object for persistence.
+		 * @return Applied, or InvalidAmount if the amount is out of range.
+		 */
+		TransactionResult applyDeposit(double amount, BankFunds& bank, Storage& storage);
+
+		/**
+		 * @brief Applies a withdrawal of a known amount without prompting.
+		 *
+		 * Shared by the interactive menu and batch ingestion.
+		 *
+		 * @param amount Amount to withdraw.
+		 * @param bank Reference to the central BankFunds object.
+		 * @param storage Reference to the data storage object for persistence.
+		 * @return Applied, InsufficientFunds, or InvalidAmount.
+		 */
+		TransactionResult applyWithdrawal(double amount, BankFunds& bank, Storage& storage);
+
 		/**
 		 * @brief Logs a financial transaction in the accounts transaction history.
 		 *
-		 * Records the type, amount, resulting balance, and timestamp.
+		 * Records the type, amount, resulting balance, and timestamp, then appends the
+		 * transaction to the storage journal.
+		 *
+		 * @param type Type of transaction.
+		 * @param amount Amount of the transaction.
+		 * @param resultingBalance Balance after the transaction.
+		 * @param storage Reference to the storage system for persistence.
+		 */
+		void logTransaction(TransactionType type, double amount, double resultingBalance, Storage& storage);
+
+		/**
+		 * @brief Logs a financial transaction that happened at a given time.
+		 *
+		 * Lets a caller that already stamped the bank totals with a time record the same
+		 * one, so the live volume buckets match the ones a journal replay rebuilds.
 		 *
-		 * @param type Type of transaction ("Deposit" or "Withdrawal").
+		 * @param type Type of transaction.
 		 * @param amount Amount of the transaction.
 		 * @param resultingBalance Balance after the transaction.
 		 * @param storage Reference to the storage system for persistence.
+		 * @param when Time the transaction happened.
+		 */
+		void logTransaction(TransactionType type, double amount, double resultingBalance, Storage& storage, std::time_t when);
+
+		/**
+		 * @brief Adds a transaction to the in-memory history without persisting it.
+		 *
+		 * Used by logTransaction and when replaying the journal on startup.
+		 *
+		 * @param type Type of transaction.
+		 * @param amount Amount of the transaction.
+		 * @param resultingBalance Balance after the transaction.
+		 * @param when Time the transaction happened.
+		 */
+		void recordTransaction(TransactionType type, double amount, double resultingBalance, std::time_t when);
+
+		// Transaction Formatting
+
+		/**
+		 * @brief Gets the display name of a transaction type.
+		 * @param type Transaction type.
+		 * @return "Deposit" or "Withdrawal".
+		 */
+		static const char* typeName(TransactionType type);
+
+		/**
+		 * @brief Parses a display name written by older versions of the program.
+		 * @param name "Deposit" or "Withdrawal".
+		 * @return Matching type; anything other than "Deposit" is a withdrawal.
+		 */
+		static TransactionType parseTypeName(const std::string& name);
+
+		/**
+		 * @brief Formats a timestamp as local time, "YYYY-MM-DD HH:MM:SS".
+		 * @param timestamp Seconds since the epoch.
+		 * @return Formatted time.
+		 */
+		static std::string formatTimestamp(std::int64_t timestamp);
+
+		/**
+		 * @brief Parses a local time written by formatTimestamp.
+		 * @param text Formatted time.
+		 * @return Seconds since the epoch, or 0 if the text cannot be parsed.
+		 */
+		static std::int64_t parseTimestamp(const std::string& text);
+
+		// History Residency
+
+		/**
+		 * @brief Checks whether the transaction history is in memory.
+		 * @return True if getTransaction may be called.
+		 */
+		bool isHistoryLoaded() const;
+
+		/**
+		 * @brief Checks whether the history has transactions not yet written to accounts.dat.
+		 * @return True if the history must not be evicted.
+		 */
+		bool isHistoryDirty() const;
+
+		/**
+		 * @brief Checks whether the account's record in accounts.dat is out of date.
+		 *
+		 * Set by every mutator and by new transactions, so a checkpoint only rewrites
+		 * the accounts that changed.
+		 *
+		 * @return True if the record must be written again.
+		 */
+		bool isRecordDirty() const;
+
+		/**
+		 * @brief Records that the account's record has been written.
+		 */
+		void markRecordStored();
+
+		/**
+		 * @brief Checks whether the account changed since markRecordStored.
+		 *
+		 * Unlike isRecordDirty, ignores a history that is still waiting to be stored, so a
+		 * background checkpoint can tell whether an account it captured changed again
+		 * while the snapshot was being written.
+		 *
+		 * @return True if a field or the history changed.
+		 */
+		bool isRecordModified() const;
+
+		/**
+		 * @brief Marks the record as out of date, after a write of it failed.
+		 */
+		void markRecordDirty();
+
+		/**
+		 * @brief Gets the location of the stored history in accounts.dat.
+		 * @return Offset assigned by Storage when the history was last stored.
+		 */
+		std::uint64_t getHistoryOffset() const;
+
+		/**
+		 * @brief Records where the history is stored and marks it as not loaded.
+		 *
+		 * Used when loading account headers without their histories.
+		 *
+		 * @param offset Location of the stored history.
+		 * @param count Number of stored transactions.
+		 */
+		void setStoredHistory(std::uint64_t offset, int count);
+
+		/**
+		 * @brief Marks the history as changed since it was stored.
+		 */
+		void markHistoryDirty();
+
+		/**
+		 * @brief Records that the current history has been written to the given location.
+		 * @param offset Location of the stored history.
+		 */
+		void markHistoryStored(std::uint64_t offset);
+
+		/**
+		 * @brief Replaces the history with transactions read from storage.
+		 *
+		 * @param history Transactions in chronological order, at most maxTransactions.
+		 */
+		void restoreHistory(History&& history);
+
+		/**
+		 * @brief Frees the in-memory history of a clean account.
+		 *
+		 * The history can be restored later from its stored location.
 		 */
-		void logTransaction(const std::string& type, double amount, double resultingBalance, Storage& storage);
+		void releaseHistory();
+
+		/**
+		 * @brief Estimates the heap memory held by the in-memory history.
+		 * @return Approximate size in bytes.
+		 */
+		std::size_t getHistoryMemory() const;
+
+		/**
+		 * @brief Gets the memory resource the history is allocated from.
+		 * @return Resource to build a replacement history with, so restoring it does not copy.
+		 */
+		std::pmr::memory_resource* getHistoryResource() const;
 
 		// Serialization
 
@@ -167,6 +474,22 @@ namespace bankSimulation {
 		 * @brief Displays the accounts transaction history.
 		 */
 		void printAccountHistory() const;
+
+		/**
+		 * @brief Displays a run of stored transactions, oldest first.
+		 * @param range Positions to print, as returned by transactionsBetween or lastTransactions.
+		 */
+		void printTransactions(TransactionRange range) const;
+
+		/**
+		 * @brief Prompts for two dates and displays the transactions made between them.
+		 */
+		void printHistoryBetween() const;
+
+		/**
+		 * @brief Prompts for a count and displays that many of the newest transactions.
+		 */
+		void printRecentHistory() const;
 	};
 
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+#include "AccountArena.h"
+
+namespace bankSimulation {
+
+    /**
+     * @brief Creates an empty arena that takes its blocks from the heap.
+     * @param initialBlockSize Size of the first block; later blocks grow geometrically.
+     */
+    AccountArena::AccountArena(std::size_t initialBlockSize)
+        : arena(initialBlockSize, std::pmr::new_delete_resource()) {}
+
+    /**
+     * @brief Allocates from the current block under the arena lock.
+     *
+     * @param bytes Size of the allocation.
+     * @param alignment Required alignment.
+     * @return Start of the allocation.
+     */
+    void* AccountArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        return arena.allocate(bytes, alignment);
+    }
+
+    /**
+     * @brief Ignores the deallocation; the memory is reclaimed by release().
+     *
+     * A monotonic resource never reuses memory, so there is nothing to lock or update.
+     */
+    void AccountArena::do_deallocate(void*, std::size_t, std::size_t) {}
+
+    /**
+     * @brief Only the same arena can free its own memory.
+     * @param other Resource to compare with.
+     * @return True if other is this arena.
+     */
+    bool AccountArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+
+    /**
+     * @brief Returns every block to the heap.
+     */
+    void AccountArena::release() {
+        std::lock_guard<std::mutex> lock(arenaMutex);
+        arena.release();
+    }
+}
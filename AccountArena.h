@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+
+namespace bankSimulation {
+
+	/**
+	 * @class AccountArena
+	 * @brief Monotonic memory resource that account data is allocated from while loading.
+	 *
+	 * Hands out memory by bumping a pointer through large blocks, so loading a book
+	 * costs a few dozen upstream allocations instead of several per account, and
+	 * individual deallocations are free. Everything is returned at once by release()
+	 * or when the arena is destroyed.
+	 *
+	 * Unlike std::pmr::monotonic_buffer_resource on its own, allocation is serialized,
+	 * so transaction threads can grow histories that live in the arena concurrently.
+	 */
+	class AccountArena : public std::pmr::memory_resource {
+	private:
+		std::pmr::monotonic_buffer_resource arena;     ///< Underlying bump allocator
+		std::mutex arenaMutex;                         ///< Serializes allocations from arena
+
+	protected:
+		/**
+		 * @brief Allocates from the current block, taking a new block when it is full.
+		 */
+		void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+		/**
+		 * @brief Does nothing; memory is only returned by release().
+		 */
+		void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+
+		/**
+		 * @brief Checks whether memory from one resource can be freed through the other.
+		 */
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	public:
+		/**
+		 * @brief Creates an empty arena.
+		 * @param initialBlockSize Size of the first block taken from the heap; later blocks grow geometrically.
+		 */
+		explicit AccountArena(std::size_t initialBlockSize = 1024 * 1024);
+
+		AccountArena(const AccountArena&) = delete;
+		AccountArena& operator=(const AccountArena&) = delete;
+
+		/**
+		 * @brief Returns every block to the heap in one go.
+		 *
+		 * Nothing allocated from the arena may be used afterwards.
+		 */
+		void release();
+	};
+}
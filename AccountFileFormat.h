@@ -0,0 +1,177 @@
+#pragma once
+#include <cstdint>
+
+namespace bankSimulation {
+
+	/**
+	 * @brief On-disk layout of versions 2 to 4 of accounts.dat.
+	 *
+	 * The file starts with a FileHeader, followed by a table of fixed-size AccountRecord
+	 * entries and a heap holding each account's strings and transaction history. All
+	 * heap positions are stored as offsets from the start of the heap, so the file can
+	 * be memory mapped and read in place.
+	 *
+	 * Version 4 makes the file updatable in place. Every account keeps its slot in the
+	 * record table, the table has spare slots for new accounts, and each history sits in
+	 * an extent with room to grow. A checkpoint then writes only the changed records, the
+	 * new history entries and the header; a history that outgrows its extent moves to a
+	 * new one at the end of the heap. Each record also notes the journal sequence it is
+	 * current to, so a checkpoint interrupted halfway replays cleanly.
+	 *
+	 * Version 3 stores each transaction as a fixed HistoryRecord with a type code and an
+	 * epoch timestamp. Version 2 stored the type and timestamp as heap strings
+	 * (HistoryRecordV2) and is still read. Both use the first 72 bytes of AccountRecord.
+	 *
+	 * Version 1 files have no header and start directly with the account count.
+	 */
+	namespace accountFile {
+
+		/// Marks a version 2 or later file; never a plausible version 1 account count
+		const char magic[4] = { 'L', 'B', 'A', 'C' };
+
+		/// Current layout version written by Storage::saveAccount
+		const std::uint32_t currentVersion = 4;
+
+		/// Oldest layout version that starts with a FileHeader
+		const std::uint32_t firstMappedVersion = 2;
+
+		/// First layout version whose records have history extents and journal sequences
+		const std::uint32_t firstUpdatableVersion = 4;
+
+		/**
+		 * @struct FileHeader
+		 * @brief First bytes of the file.
+		 */
+		struct FileHeader {
+			char magic[4];                    ///< Always accountFile::magic
+			std::uint32_t version;            ///< Layout version
+			std::uint64_t accountCount;       ///< Number of entries in the record table
+			std::uint64_t journalSequence;    ///< Last journal record included in the file
+			std::uint64_t recordTableOffset;  ///< File offset of the record table
+			std::uint64_t heapOffset;         ///< File offset of the heap
+			std::uint64_t heapSize;           ///< Length of the heap in bytes
+			std::uint32_t lastAccountNumber;  ///< Next account number to hand out
+			std::uint32_t reserved;           ///< Padding, always 0
+		};
+
+		/**
+		 * @struct HeapString
+		 * @brief Location of a string in the heap.
+		 */
+		struct HeapString {
+			std::uint64_t offset;             ///< Offset from the start of the heap
+			std::uint32_t length;             ///< Length in bytes, no terminator
+			std::uint32_t reserved;           ///< Padding, always 0
+		};
+
+		/**
+		 * @struct AccountRecord
+		 * @brief Fixed-size entry of the record table.
+		 */
+		struct AccountRecord {
+			std::uint32_t accountNumber;      ///< Unique account number
+			std::uint32_t historyCount;       ///< Number of HistoryRecord entries
+			double balance;                   ///< Current balance
+			HeapString firstName;             ///< Holder's first name
+			HeapString lastName;              ///< Holder's last name
+			HeapString password;              ///< Holder's password
+			std::uint64_t historyOffset;      ///< Heap offset of the first HistoryRecord
+			std::uint32_t historyCapacity;    ///< HistoryRecord entries the extent has room for (version 4)
+			std::uint32_t reserved;           ///< Padding, always 0
+			std::uint64_t journalSequence;    ///< Last journal record applied to this account (version 4)
+		};
+
+		/**
+		 * @struct HistoryRecord
+		 * @brief One transaction in the heap, oldest first.
+		 */
+		struct HistoryRecord {
+			std::int64_t timestamp;           ///< Seconds since the epoch
+			double amount;                    ///< Amount of the transaction
+			double resultingBalance;          ///< Balance after the transaction
+			std::uint8_t type;                ///< 'D' for deposit, 'W' for withdrawal
+			std::uint8_t reserved[7];         ///< Padding, always 0
+		};
+
+		/**
+		 * @struct HistoryRecordV2
+		 * @brief One transaction in a version 2 heap, with text type and timestamp.
+		 */
+		struct HistoryRecordV2 {
+			double amount;                    ///< Amount of the transaction
+			double resultingBalance;          ///< Balance after the transaction
+			HeapString type;                  ///< "Deposit" or "Withdrawal"
+			HeapString timestamp;             ///< Formatted time of the transaction
+		};
+
+		/**
+		 * @brief Gets the size of one history entry in a given layout version.
+		 * @param version Layout version of the file.
+		 * @return Bytes per transaction in the heap.
+		 */
+		inline std::uint64_t historyRecordSize(std::uint32_t version) {
+			return version == 2 ? sizeof(HistoryRecordV2) : sizeof(HistoryRecord);
+		}
+
+		/**
+		 * @brief Gets the size of one record table entry in a given layout version.
+		 * @param version Layout version of the file.
+		 * @return Bytes per account in the record table.
+		 */
+		inline std::uint64_t accountRecordSize(std::uint32_t version) {
+			return version < firstUpdatableVersion ? 72 : sizeof(AccountRecord);
+		}
+
+		/**
+		 * @brief Chooses the extent size for a history being written.
+		 *
+		 * Leaves room for half as many transactions again (at least 4), so a busy account
+		 * moves to a new extent a logarithmic number of times, never past the history limit.
+		 *
+		 * @param count Transactions stored now.
+		 * @param limit Most transactions a history holds.
+		 * @return HistoryRecord entries to reserve.
+		 */
+		inline std::uint32_t historyCapacityFor(std::uint32_t count, std::uint32_t limit) {
+			std::uint32_t wanted = count + count / 2 + 4;
+			return wanted < limit ? wanted : (count > limit ? count : limit);
+		}
+
+		/**
+		 * @brief Chooses the record table size for a file being written.
+		 * @param accountCount Accounts stored now.
+		 * @return Slots to reserve, leaving room for new accounts.
+		 */
+		inline std::uint64_t tableCapacityFor(std::uint64_t accountCount) {
+			return accountCount + accountCount / 16 + 16;
+		}
+
+		/**
+		 * @brief Rounds a heap offset up so the next account block is 8-byte aligned.
+		 * @param offset Heap offset to round.
+		 * @return Aligned offset.
+		 */
+		inline std::uint64_t alignHeap(std::uint64_t offset) {
+			return (offset + 7) & ~static_cast<std::uint64_t>(7);
+		}
+
+		/**
+		 * @brief Gets the heap space taken by an account's block.
+		 *
+		 * A block is the history extent followed by the first name, last name and password.
+		 *
+		 * @param record Version 4 record of the account.
+		 * @return Block size in bytes, including padding.
+		 */
+		inline std::uint64_t blockSize(const AccountRecord& record) {
+			return alignHeap(record.historyCapacity * sizeof(HistoryRecord)
+				+ record.firstName.length + record.lastName.length + record.password.length);
+		}
+
+		static_assert(sizeof(FileHeader) == 56, "FileHeader layout changed");
+		static_assert(sizeof(HeapString) == 16, "HeapString layout changed");
+		static_assert(sizeof(AccountRecord) == 88, "AccountRecord layout changed");
+		static_assert(sizeof(HistoryRecord) == 32, "HistoryRecord layout changed");
+		static_assert(sizeof(HistoryRecordV2) == 48, "HistoryRecordV2 layout changed");
+	}
+}
@@ -0,0 +1,206 @@
+#include "AccountFileUpdater.h"
+#include "AccountFileWriter.h"
+#include <cstring>
+
+namespace bankSimulation {
+
+    /**
+     * @brief Opens a file for update and reads its header.
+     *
+     * Only a file in the current layout can be updated; anything else needs a full
+     * rewrite, which isOpen reports.
+     *
+     * @param path File to update.
+     */
+    AccountFileUpdater::AccountFileUpdater(const std::string& path) {
+        if (!file.openForUpdate(path) || !file.readAt(0, &header, sizeof(header))
+            || std::memcmp(header.magic, accountFile::magic, sizeof(header.magic)) != 0
+            || header.version != accountFile::currentVersion) {
+            return;
+        }
+        updatable = true;
+        heapEnd = header.heapSize;
+    }
+
+    /**
+     * @brief Checks that the file exists in the current layout.
+     * @return True if accounts can be updated in place.
+     */
+    bool AccountFileUpdater::isOpen() const {
+        return updatable;
+    }
+
+    /**
+     * @brief Checks whether the record table has a slot for every account.
+     * @param accountCount Accounts to store.
+     * @return True if the slots before the heap suffice.
+     */
+    bool AccountFileUpdater::canHold(std::uint64_t accountCount) const {
+        return slotOffset(accountCount) <= header.heapOffset;
+    }
+
+    /**
+     * @brief Gets the file offset of a slot in the record table.
+     * @param slot Account handle.
+     * @return File offset.
+     */
+    std::uint64_t AccountFileUpdater::slotOffset(std::uint64_t slot) const {
+        return header.recordTableOffset + slot * sizeof(accountFile::AccountRecord);
+    }
+
+    /**
+     * @brief Writes bytes into the heap, remembering any failure.
+     * @param heapOffset Offset from the start of the heap.
+     * @param data Bytes to write.
+     * @param size Number of bytes.
+     */
+    void AccountFileUpdater::writeHeap(std::uint64_t heapOffset, const void* data, std::size_t size) {
+        if (size > 0 && !file.writeAt(header.heapOffset + heapOffset, data, size)) {
+            failed = true;
+        }
+    }
+
+    /**
+     * @brief Rewrites an account's strings in place.
+     *
+     * The lengths are unchanged, so this only matters for a password changed to one
+     * of the same length; the strings are a few bytes and sit in the block anyway.
+     *
+     * @param account Account supplying the strings.
+     * @param record Stored record whose string lengths match the account's.
+     */
+    void AccountFileUpdater::writeStrings(const Account& account, const accountFile::AccountRecord& record) {
+        buffer.clear();
+        buffer.insert(buffer.end(), account.getHolderFirstName().begin(), account.getHolderFirstName().end());
+        buffer.insert(buffer.end(), account.getHolderLastName().begin(), account.getHolderLastName().end());
+        buffer.insert(buffer.end(), account.getHolderPassword().begin(), account.getHolderPassword().end());
+        writeHeap(record.firstName.offset, buffer.data(), buffer.size());
+    }
+
+    /**
+     * @brief Writes the heap data of a changed or new account.
+     *
+     * Picks the cheapest write that leaves the stored block intact until commit:
+     * - history unchanged: nothing, only the record changes;
+     * - history grew without wrapping and fits its extent: just the new entries, into
+     *   the free part of the extent that the stored record does not cover yet;
+     * - otherwise, or if a string changed length: a new block at the end of the heap.
+     *
+     * @param slot Account handle, which is its slot in the table.
+     * @param account Changed account.
+     * @param journalSequence Last journal record the account includes.
+     * @return Record the slot will hold.
+     */
+    accountFile::AccountRecord AccountFileUpdater::update(std::uint64_t slot, const Account& account, std::uint64_t journalSequence) {
+        accountFile::AccountRecord stored = {};
+        bool existing = slot < header.accountCount;
+        if (existing && !file.readAt(slotOffset(slot), &stored, sizeof(stored))) {
+            failed = true;
+            return stored;
+        }
+
+        bool sameStrings = existing
+            && stored.firstName.length == account.getHolderFirstName().size()
+            && stored.lastName.length == account.getHolderLastName().size()
+            && stored.password.length == account.getHolderPassword().size();
+        std::uint32_t count = static_cast<std::uint32_t>(account.getTransactionCount());
+
+        accountFile::AccountRecord record = stored;
+        if (sameStrings && (!account.isHistoryLoaded() || !account.isHistoryDirty())) {
+            writeStrings(account, stored);
+        }
+        else if (sameStrings && count < Account::maxTransactions && count >= stored.historyCount && count <= stored.historyCapacity) {
+            buffer.resize((count - stored.historyCount) * sizeof(accountFile::HistoryRecord));
+            for (std::uint32_t i = stored.historyCount; i < count; ++i) {
+                accountFile::HistoryRecord entry = AccountFileWriter::encodeTransaction(account.getTransaction(static_cast<int>(i)));
+                std::memcpy(buffer.data() + (i - stored.historyCount) * sizeof(entry), &entry, sizeof(entry));
+            }
+            writeHeap(stored.historyOffset + stored.historyCount * sizeof(accountFile::HistoryRecord), buffer.data(), buffer.size());
+            writeStrings(account, stored);
+            record.historyCount = count;
+        }
+        else if (account.isHistoryLoaded()) {
+            record = AccountFileWriter::encodeBlock(account, heapEnd, journalSequence, buffer);
+            writeHeap(heapEnd, buffer.data(), buffer.size());
+            heapEnd += buffer.size();
+            if (existing) {
+                released += accountFile::blockSize(stored);
+            }
+        }
+        else {
+            // Moving a block needs its history; Storage loads every changed one first
+            failed = true;
+            return stored;
+        }
+
+        record.accountNumber = account.getHolderAccountNumber();
+        record.balance = account.getBalance();
+        record.journalSequence = journalSequence;
+
+        if (existing) {
+            replaced.emplace_back(slot, record);
+        }
+        else if (!file.writeAt(slotOffset(slot), &record, sizeof(record))) {
+            failed = true;
+        }
+        return record;
+    }
+
+    /**
+     * @brief Makes every update durable and moves the header to the new state.
+     *
+     * 1. Sync the new heap data and new slots, which nothing references yet.
+     * 2. If the heap or the table grew, write and sync the header with the new sizes,
+     *    still naming the old journal sequence.
+     * 3. Write and sync the replaced records. Each names the new sequence, so a crash
+     *    before step 4 replays only the transactions of records not yet written.
+     * 4. Write and sync the header with the new journal sequence.
+     *
+     * @param accountCount Accounts stored, including new ones.
+     * @param journalSequence Last journal record included in the file.
+     * @param lastAccountNumber Next account number to hand out.
+     * @return False if any read, write or sync failed.
+     */
+    bool AccountFileUpdater::commit(std::uint64_t accountCount, std::uint64_t journalSequence, std::uint32_t lastAccountNumber) {
+        if (!updatable || failed || !file.sync()) {
+            return false;
+        }
+
+        if (heapEnd != header.heapSize || accountCount != header.accountCount || lastAccountNumber != header.lastAccountNumber) {
+            header.heapSize = heapEnd;
+            header.accountCount = accountCount;
+            header.lastAccountNumber = lastAccountNumber;
+            if (!file.writeAt(0, &header, sizeof(header)) || !file.sync()) {
+                return false;
+            }
+        }
+
+        for (const auto& entry : replaced) {
+            if (!file.writeAt(slotOffset(entry.first), &entry.second, sizeof(entry.second))) {
+                return false;
+            }
+        }
+        if (!replaced.empty() && !file.sync()) {
+            return false;
+        }
+
+        header.journalSequence = journalSequence;
+        return file.writeAt(0, &header, sizeof(header)) && file.sync();
+    }
+
+    /**
+     * @brief Gets the header as stored, or as committed once commit succeeds.
+     * @return File header.
+     */
+    const accountFile::FileHeader& AccountFileUpdater::getHeader() const {
+        return header;
+    }
+
+    /**
+     * @brief Gets the heap space given up by blocks that moved.
+     * @return Bytes no longer referenced.
+     */
+    std::uint64_t AccountFileUpdater::getReleasedBytes() const {
+        return released;
+    }
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Account.h"
+#include "AccountFileFormat.h"
+#include "DurableFile.h"
+
+namespace bankSimulation {
+
+	/**
+	 * @class AccountFileUpdater
+	 * @brief Writes changed accounts into an existing accounts.dat in place.
+	 *
+	 * Each account keeps its slot in the record table. New transactions are written
+	 * into the free part of the account's history extent when they fit; otherwise the
+	 * whole block moves to the end of the heap and the old one becomes garbage, which
+	 * the next full rewrite reclaims. New accounts take spare slots in the table.
+	 *
+	 * commit() orders the writes so that a crash at any point leaves a file that loads:
+	 * new heap data and new slots are synced before the header makes them reachable,
+	 * and the header's journal sequence only moves once every record is synced. Each
+	 * record carries its own journal sequence, so replay skips the transactions that a
+	 * half-finished commit already stored.
+	 */
+	class AccountFileUpdater {
+	private:
+		DurableFile file;                        ///< Reads the records being replaced and writes at explicit offsets
+		accountFile::FileHeader header = {};     ///< Header as stored, then as committed
+		bool updatable = false;                  ///< Whether the file has the current layout
+		bool failed = false;                     ///< Whether a read or write failed
+		std::uint64_t heapEnd = 0;               ///< Heap size including blocks moved so far
+		std::uint64_t released = 0;              ///< Heap bytes of blocks that were moved away
+		std::vector<char> buffer;                ///< Reused buffer for encoded blocks and entries
+		std::vector<std::pair<std::uint64_t, accountFile::AccountRecord>> replaced;  ///< Records of existing slots, written by commit
+
+		/**
+		 * @brief Gets the file offset of a slot in the record table.
+		 * @param slot Account handle.
+		 * @return File offset.
+		 */
+		std::uint64_t slotOffset(std::uint64_t slot) const;
+
+		/**
+		 * @brief Writes bytes into the heap, remembering any failure.
+		 * @param heapOffset Offset from the start of the heap.
+		 * @param data Bytes to write.
+		 * @param size Number of bytes.
+		 */
+		void writeHeap(std::uint64_t heapOffset, const void* data, std::size_t size);
+
+		/**
+		 * @brief Rewrites an account's strings where its block already holds them.
+		 * @param account Account supplying the strings.
+		 * @param record Stored record whose string lengths match the account's.
+		 */
+		void writeStrings(const Account& account, const accountFile::AccountRecord& record);
+
+	public:
+		/**
+		 * @brief Opens a file and reads its header.
+		 * @param path File to update.
+		 */
+		explicit AccountFileUpdater(const std::string& path);
+
+		/**
+		 * @brief Checks that the file exists in the current layout.
+		 * @return True if accounts can be updated in place.
+		 */
+		bool isOpen() const;
+
+		/**
+		 * @brief Checks whether the record table has a slot for every account.
+		 * @param accountCount Accounts to store.
+		 * @return True if no table growth is needed.
+		 */
+		bool canHold(std::uint64_t accountCount) const;
+
+		/**
+		 * @brief Writes the heap data of a changed or new account.
+		 *
+		 * A new account's record goes into its spare slot at once; it stays invisible
+		 * until commit raises the account count. A replaced record is kept for commit.
+		 *
+		 * @param slot Account handle, which is its slot in the table.
+		 * @param account Changed account. Its history must be loaded if it changed.
+		 * @param journalSequence Last journal record the account includes.
+		 * @return Record the slot will hold.
+		 */
+		accountFile::AccountRecord update(std::uint64_t slot, const Account& account, std::uint64_t journalSequence);
+
+		/**
+		 * @brief Makes every update durable and moves the header to the new state.
+		 *
+		 * @param accountCount Accounts stored, including new ones.
+		 * @param journalSequence Last journal record included in the file.
+		 * @param lastAccountNumber Next account number to hand out.
+		 * @return False if any read, write or sync failed.
+		 */
+		bool commit(std::uint64_t accountCount, std::uint64_t journalSequence, std::uint32_t lastAccountNumber);
+
+		/**
+		 * @brief Gets the header as stored, or as committed once commit succeeds.
+		 * @return File header.
+		 */
+		const accountFile::FileHeader& getHeader() const;
+
+		/**
+		 * @brief Gets the heap space given up by blocks that moved.
+		 * @return Bytes no longer referenced.
+		 */
+		std::uint64_t getReleasedBytes() const;
+	};
+}
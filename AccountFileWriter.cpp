@@ -0,0 +1,241 @@
+#include "AccountFileWriter.h"
+#include "DurableFile.h"
+#include <cstring>
+#include <string_view>
+
+namespace bankSimulation {
+    namespace {
+        /**
+         * @brief Reserves room for a string in the heap.
+         * @param cursor Heap offset to place the string at; advanced past it.
+         * @param text String to place.
+         * @return Heap reference to the string.
+         */
+        accountFile::HeapString placeString(std::uint64_t& cursor, std::string_view text) {
+            accountFile::HeapString ref = {};
+            ref.offset = cursor;
+            ref.length = static_cast<std::uint32_t>(text.size());
+            cursor += text.size();
+            return ref;
+        }
+
+        /**
+         * @brief Encodes an account's record and heap block.
+         *
+         * The history extent is sized by accountFile::historyCapacityFor; its unused
+         * entries are zero.
+         *
+         * @param account Account supplying the names, number, and balance.
+         * @param historyCount Number of transactions to store.
+         * @param transactionAt Returns the transaction at a chronological position.
+         * @param blockOffset Heap offset the block will be written at.
+         * @param journalSequence Last journal record the account includes.
+         * @param block Buffer receiving the block; replaced.
+         * @return Record describing the block.
+         */
+        template <typename TransactionAt>
+        accountFile::AccountRecord encodeAccount(const Account& account, int historyCount, TransactionAt transactionAt,
+            std::uint64_t blockOffset, std::uint64_t journalSequence, std::vector<char>& block) {
+            accountFile::AccountRecord record = {};
+            record.accountNumber = account.getHolderAccountNumber();
+            record.historyCount = static_cast<std::uint32_t>(historyCount);
+            record.historyCapacity = accountFile::historyCapacityFor(record.historyCount, Account::maxTransactions);
+            record.balance = account.getBalance();
+            record.historyOffset = blockOffset;
+            record.journalSequence = journalSequence;
+
+            std::uint64_t cursor = blockOffset + record.historyCapacity * sizeof(accountFile::HistoryRecord);
+            record.firstName = placeString(cursor, account.getHolderFirstName());
+            record.lastName = placeString(cursor, account.getHolderLastName());
+            record.password = placeString(cursor, account.getHolderPassword());
+
+            block.assign(static_cast<std::size_t>(accountFile::blockSize(record)), 0);
+            char* next = block.data();
+            for (int i = 0; i < historyCount; ++i) {
+                accountFile::HistoryRecord history = AccountFileWriter::encodeTransaction(transactionAt(i));
+                std::memcpy(next, &history, sizeof(history));
+                next += sizeof(history);
+            }
+
+            next = block.data() + record.historyCapacity * sizeof(accountFile::HistoryRecord);
+            for (std::string_view text : { std::string_view(account.getHolderFirstName()),
+                std::string_view(account.getHolderLastName()), std::string_view(account.getHolderPassword()) }) {
+                std::memcpy(next, text.data(), text.size());
+                next += text.size();
+            }
+            return record;
+        }
+    }
+
+    /**
+     * @brief Creates or truncates the file and positions both streams.
+     *
+     * The heap stream creates the file; the table stream reopens it for update so the
+     * two can write their regions independently. The table gets spare slots beyond
+     * accountCount, which stay zero.
+     *
+     * @param path File to write.
+     * @param accountCount Exact number of accounts that will be added.
+     * @param journalSequence Last journal record included in the file.
+     * @param lastAccountNumber Next account number to hand out.
+     */
+    AccountFileWriter::AccountFileWriter(const std::string& path, std::uint64_t accountCount,
+        std::uint64_t journalSequence, std::uint32_t lastAccountNumber) : path(path) {
+        std::memcpy(header.magic, accountFile::magic, sizeof(header.magic));
+        header.version = accountFile::currentVersion;
+        header.accountCount = accountCount;
+        header.journalSequence = journalSequence;
+        header.recordTableOffset = sizeof(header);
+        header.heapOffset = header.recordTableOffset + accountFile::tableCapacityFor(accountCount) * sizeof(accountFile::AccountRecord);
+        header.lastAccountNumber = lastAccountNumber;
+
+        heap.open(path, std::ios::binary | std::ios::trunc);
+        if (heap) {
+            table.open(path, std::ios::binary | std::ios::in | std::ios::out);
+        }
+        table.seekp(static_cast<std::streamoff>(header.recordTableOffset));
+        heap.seekp(static_cast<std::streamoff>(header.heapOffset));
+    }
+
+    /**
+     * @brief Checks that the file was opened.
+     * @return True if accounts can be added.
+     */
+    bool AccountFileWriter::isOpen() const {
+        return heap.is_open() && table.is_open();
+    }
+
+    /**
+     * @brief Encodes an account's heap block for a given position.
+     *
+     * @param account Account whose history is loaded.
+     * @param blockOffset Heap offset the block will be written at.
+     * @param journalSequence Last journal record the account includes.
+     * @param block Buffer receiving the block; replaced.
+     * @return Record describing the block.
+     */
+    accountFile::AccountRecord AccountFileWriter::encodeBlock(const Account& account, std::uint64_t blockOffset,
+        std::uint64_t journalSequence, std::vector<char>& block) {
+        return encodeAccount(account, account.getTransactionCount(),
+            [&account](int i) -> const Account::Transaction& { return account.getTransaction(i); },
+            blockOffset, journalSequence, block);
+    }
+
+    /**
+     * @brief Converts a transaction to its heap entry.
+     * @param transaction Transaction to store.
+     * @return Entry with zero padding.
+     */
+    accountFile::HistoryRecord AccountFileWriter::encodeTransaction(const Account::Transaction& transaction) {
+        accountFile::HistoryRecord history = {};
+        history.timestamp = transaction.timestamp;
+        history.amount = transaction.amount;
+        history.resultingBalance = transaction.resultingBalance;
+        history.type = static_cast<std::uint8_t>(transaction.type);
+        return history;
+    }
+
+    /**
+     * @brief Writes the encoded block onto the heap and the record into the table.
+     * @param record Record of the account, pointing at heapCursor.
+     * @return The record.
+     */
+    accountFile::AccountRecord AccountFileWriter::writeEncoded(const accountFile::AccountRecord& record) {
+        table.write(reinterpret_cast<const char*>(&record), sizeof(record));
+        heap.write(block.data(), static_cast<std::streamsize>(block.size()));
+        heapCursor += block.size();
+        ++written;
+        return record;
+    }
+
+    /**
+     * @brief Adds an account together with its in-memory history.
+     * @param account Account whose history is loaded.
+     * @return Record written.
+     */
+    accountFile::AccountRecord AccountFileWriter::add(const Account& account) {
+        return writeEncoded(encodeBlock(account, heapCursor, header.journalSequence, block));
+    }
+
+    /**
+     * @brief Adds an account whose history was read separately.
+     * @param account Account supplying the names, number, and balance.
+     * @param history Transactions in chronological order.
+     * @return Record written.
+     */
+    accountFile::AccountRecord AccountFileWriter::add(const Account& account, const Account::History& history) {
+        return writeEncoded(encodeAccount(account, static_cast<int>(history.size()),
+            [&history](int i) -> const Account::Transaction& { return history[i]; },
+            heapCursor, header.journalSequence, block));
+    }
+
+    /**
+     * @brief Adds an account by copying its history entries and strings from another file.
+     *
+     * The entries are already in the current layout, so they are copied as they are;
+     * only the record's offsets, capacity and journal sequence change.
+     *
+     * @param stored Record of the account in the source file.
+     * @param heap Start of the source heap.
+     * @return Record written.
+     */
+    accountFile::AccountRecord AccountFileWriter::addStored(const accountFile::AccountRecord& stored, const char* heap) {
+        accountFile::AccountRecord record = stored;
+        record.historyCapacity = accountFile::historyCapacityFor(stored.historyCount, Account::maxTransactions);
+        record.historyOffset = heapCursor;
+        record.journalSequence = header.journalSequence;
+
+        std::uint64_t cursor = heapCursor + record.historyCapacity * sizeof(accountFile::HistoryRecord);
+        record.firstName = placeString(cursor, std::string_view(heap + stored.firstName.offset, stored.firstName.length));
+        record.lastName = placeString(cursor, std::string_view(heap + stored.lastName.offset, stored.lastName.length));
+        record.password = placeString(cursor, std::string_view(heap + stored.password.offset, stored.password.length));
+
+        block.assign(static_cast<std::size_t>(accountFile::blockSize(record)), 0);
+        std::memcpy(block.data(), heap + stored.historyOffset, stored.historyCount * sizeof(accountFile::HistoryRecord));
+
+        char* next = block.data() + record.historyCapacity * sizeof(accountFile::HistoryRecord);
+        for (const accountFile::HeapString* text : { &stored.firstName, &stored.lastName, &stored.password }) {
+            std::memcpy(next, heap + text->offset, text->length);
+            next += text->length;
+        }
+        return writeEncoded(record);
+    }
+
+    /**
+     * @brief Writes the header, closes the file and syncs it.
+     *
+     * The header goes last, so a file whose writing was interrupted never claims a
+     * complete heap. The sync makes sure the file is complete on disk before the caller
+     * renames it over the previous one.
+     *
+     * @return False if any write failed or fewer accounts were added than announced.
+     */
+    bool AccountFileWriter::finish() {
+        header.heapSize = heapCursor;
+
+        heap.close();
+        table.seekp(0);
+        table.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        table.close();
+
+        DurableFile file;
+        bool synced = file.openForUpdate(path) && file.sync();
+        return synced && !heap.fail() && !table.fail() && written == header.accountCount;
+    }
+
+    /**
+     * @brief Gets the header written by finish.
+     * @return Header with the final heap size.
+     */
+    const accountFile::FileHeader& AccountFileWriter::getHeader() const {
+        return header;
+    }
+
+    /**
+     * @brief Gets the file offset of the heap.
+     * @return Heap offset.
+     */
+    std::uint64_t AccountFileWriter::getHeapOffset() const {
+        return header.heapOffset;
+    }
+}
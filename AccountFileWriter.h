@@ -0,0 +1,128 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Account.h"
+#include "AccountFileFormat.h"
+
+namespace bankSimulation {
+
+	/**
+	 * @class AccountFileWriter
+	 * @brief Streams accounts into a file in the current accounts.dat layout.
+	 *
+	 * The number of accounts is fixed up front, so the record table and the heap both
+	 * have known starting offsets. Each added account writes its record into the table
+	 * and its block onto the end of the heap through two separate streams on the same
+	 * file, so accounts are written in a single pass without being held in memory.
+	 *
+	 * The table and every history extent are written with spare room, so the finished
+	 * file can later be updated in place by AccountFileUpdater.
+	 */
+	class AccountFileWriter {
+	private:
+		std::string path;                       ///< File being written
+		std::ofstream table;                    ///< Stream positioned in the record table
+		std::ofstream heap;                     ///< Stream positioned at the end of the heap
+		accountFile::FileHeader header = {};    ///< Header written by finish
+		std::uint64_t heapCursor = 0;           ///< Heap offset of the next account block
+		std::uint64_t written = 0;              ///< Accounts added so far
+		std::vector<char> block;                ///< Reused buffer one account block is encoded into
+
+		/**
+		 * @brief Writes an encoded account's record and heap block.
+		 * @param record Record of the account, pointing at heapCursor.
+		 * @return The record.
+		 */
+		accountFile::AccountRecord writeEncoded(const accountFile::AccountRecord& record);
+
+	public:
+		/**
+		 * @brief Creates or truncates the file and positions both streams.
+		 *
+		 * @param path File to write.
+		 * @param accountCount Exact number of accounts that will be added.
+		 * @param journalSequence Last journal record included in the file.
+		 * @param lastAccountNumber Next account number to hand out.
+		 */
+		AccountFileWriter(const std::string& path, std::uint64_t accountCount,
+			std::uint64_t journalSequence, std::uint32_t lastAccountNumber);
+
+		/**
+		 * @brief Checks that the file was opened.
+		 * @return True if accounts can be added.
+		 */
+		bool isOpen() const;
+
+		/**
+		 * @brief Adds an account together with its in-memory history.
+		 *
+		 * @param account Account whose history is loaded.
+		 * @return Record written, whose history location goes to Account::markHistoryStored.
+		 */
+		accountFile::AccountRecord add(const Account& account);
+
+		/**
+		 * @brief Adds an account whose history was read separately.
+		 *
+		 * @param account Account supplying the names, number, and balance.
+		 * @param history Transactions in chronological order.
+		 * @return Record written.
+		 */
+		accountFile::AccountRecord add(const Account& account, const Account::History& history);
+
+		/**
+		 * @brief Adds an account by copying its block out of another version 4 file.
+		 *
+		 * Lets a compaction carry unchanged accounts over without building Account
+		 * objects for them. The extent is resized for the stored count, as for any
+		 * other account.
+		 *
+		 * @param stored Record of the account in the source file.
+		 * @param heap Start of the source heap, already checked to hold the whole block.
+		 * @return Record written.
+		 */
+		accountFile::AccountRecord addStored(const accountFile::AccountRecord& stored, const char* heap);
+
+		/**
+		 * @brief Writes the header, closes the file and syncs it to stable storage.
+		 * @return False if any write failed or fewer accounts were added than announced.
+		 */
+		bool finish();
+
+		/**
+		 * @brief Encodes an account's heap block for a given position.
+		 *
+		 * The block holds the history extent, then the first name, last name and password,
+		 * padded to 8 bytes. Shared with AccountFileUpdater, which moves blocks.
+		 *
+		 * @param account Account whose history is loaded.
+		 * @param blockOffset Heap offset the block will be written at.
+		 * @param journalSequence Last journal record the account includes.
+		 * @param block Buffer receiving the block; replaced.
+		 * @return Record describing the block.
+		 */
+		static accountFile::AccountRecord encodeBlock(const Account& account, std::uint64_t blockOffset,
+			std::uint64_t journalSequence, std::vector<char>& block);
+
+		/**
+		 * @brief Converts a transaction to its heap entry.
+		 * @param transaction Transaction to store.
+		 * @return Entry with zero padding.
+		 */
+		static accountFile::HistoryRecord encodeTransaction(const Account::Transaction& transaction);
+
+		/**
+		 * @brief Gets the header written by finish.
+		 * @return Header with the final heap size.
+		 */
+		const accountFile::FileHeader& getHeader() const;
+
+		/**
+		 * @brief Gets the file offset of the heap.
+		 * @return Heap offset, needed to read histories from the finished file.
+		 */
+		std::uint64_t getHeapOffset() const;
+	};
+}
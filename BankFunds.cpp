@@ -2,9 +2,60 @@
 #include "Account.h"
 #include "Storage.h"
 #include "Validators.h"
+#include <cmath>
+#include <ctime>
 #include <iomanip>
 
 namespace bankSimulation {
+    namespace {
+        /**
+         * @brief Converts a dollar amount to whole cents, rounding to the nearest cent.
+         * @param amount Amount in dollars.
+         * @return Amount in cents.
+         */
+        std::int64_t toCents(double amount) {
+            return static_cast<std::int64_t>(std::llround(amount * 100.0));
+        }
+
+        /**
+         * @brief Converts whole cents back to dollars.
+         * @param cents Amount in cents.
+         * @return Amount in dollars.
+         */
+        double toDollars(std::int64_t cents) {
+            return static_cast<double>(cents) / 100.0;
+        }
+    }
+
+    /**
+     * @brief Atomically adds a deposit to the bank totals.
+     *
+     * Each total is updated with a single atomic add on the calling thread's shard, so
+     * concurrent callers neither lose updates nor bounce one cache line between cores.
+     * The deposit is then added to its minute, hour and day buckets.
+     *
+     * @param amount Deposited amount.
+     * @param when Time of the deposit.
+     */
+    void BankFunds::recordDeposit(double amount, std::int64_t when) {
+        std::int64_t cents = toCents(amount);
+        totalDeposits.add(cents);
+        totalHoldings.add(cents);
+        volume.recordDeposit(cents, when);
+    }
+
+    /**
+     * @brief Atomically adds a withdrawal to the bank totals and its volume buckets.
+     *
+     * @param amount Withdrawn amount.
+     * @param when Time of the withdrawal.
+     */
+    void BankFunds::recordWithdrawal(double amount, std::int64_t when) {
+        std::int64_t cents = toCents(amount);
+        totalWithdrawals.add(cents);
+        totalHoldings.add(-cents);
+        volume.recordWithdrawal(cents, when);
+    }
 
     /**
      * @brief Sets the total holdings for the bank.
@@ -15,8 +66,8 @@ namespace bankSimulation {
      * @return Updated total holdings.
      */
     double BankFunds::setTotalHoldings(const double& entry) {
-        totalHoldings = entry;
-        return totalHoldings;
+        totalHoldings.store(toCents(entry));
+        return toDollars(totalHoldings.load());
     }
 
     /**
@@ -28,8 +79,8 @@ namespace bankSimulation {
      * @return Updated total deposits.
      */
     double BankFunds::setTotalDeposits(const double& entry) {
-        totalDeposits = entry;
-        return totalDeposits;
+        totalDeposits.store(toCents(entry));
+        return toDollars(totalDeposits.load());
     }
 
     /**
@@ -41,8 +92,8 @@ namespace bankSimulation {
      * @return Updated total withdrawals.
      */
     double BankFunds::setTotalWithdrawals(const double& entry) {
-        totalWithdrawals = entry;
-        return totalWithdrawals;
+        totalWithdrawals.store(toCents(entry));
+        return toDollars(totalWithdrawals.load());
     }
 
     /**
@@ -60,7 +111,7 @@ namespace bankSimulation {
      * @return Total holdings value.
      */
     double BankFunds::getTotalHoldings() const {
-        return totalHoldings;
+        return toDollars(totalHoldings.load());
     }
 
     /**
@@ -69,7 +120,7 @@ namespace bankSimulation {
      * @return Total deposits value.
      */
     double BankFunds::getTotalDeposits() const {
-        return totalDeposits;
+        return toDollars(totalDeposits.load());
     }
 
     /**
@@ -78,14 +129,32 @@ namespace bankSimulation {
      * @return Total withdrawals value.
      */
     double BankFunds::getTotalWithdrawals() const {
-        return totalWithdrawals;
+        return toDollars(totalWithdrawals.load());
+    }
+
+    /**
+     * @brief Gets the recent deposit and withdrawal volume by time bucket.
+     *
+     * @return The volume rollup.
+     */
+    VolumeRollup& BankFunds::getVolume() {
+        return volume;
+    }
+
+    /**
+     * @brief Gets the recent deposit and withdrawal volume by time bucket.
+     *
+     * @return The volume rollup.
+     */
+    const VolumeRollup& BankFunds::getVolume() const {
+        return volume;
     }
 
     /**
      * @brief Serializes the BankFunds object to a binary output stream.
      *
      * Writes the starting funds, password, total deposits, withdrawals, and holdings
-     * to the specified output stream in binary format.
+     * to the specified output stream in binary format. Totals are stored as dollars.
      *
      * @param out Output stream to serialize into.
      */
@@ -96,9 +165,12 @@ namespace bankSimulation {
         out.write(reinterpret_cast<const char*>(&passwordLength), sizeof(passwordLength));
         out.write(password.c_str(), passwordLength);
 
-        out.write(reinterpret_cast<const char*>(&totalHoldings), sizeof(totalHoldings));
-        out.write(reinterpret_cast<const char*>(&totalDeposits), sizeof(totalDeposits));
-        out.write(reinterpret_cast<const char*>(&totalWithdrawals), sizeof(totalWithdrawals));
+        double holdings = getTotalHoldings();
+        double deposits = getTotalDeposits();
+        double withdrawals = getTotalWithdrawals();
+        out.write(reinterpret_cast<const char*>(&holdings), sizeof(holdings));
+        out.write(reinterpret_cast<const char*>(&deposits), sizeof(deposits));
+        out.write(reinterpret_cast<const char*>(&withdrawals), sizeof(withdrawals));
     }
 
     /**
@@ -117,23 +189,63 @@ namespace bankSimulation {
         password.resize(passwordLength);
         in.read(&password[0], passwordLength);
 
-        in.read(reinterpret_cast<char*>(&totalHoldings), sizeof(totalHoldings));
-        in.read(reinterpret_cast<char*>(&totalDeposits), sizeof(totalDeposits));
-        in.read(reinterpret_cast<char*>(&totalWithdrawals), sizeof(totalWithdrawals));
+        double holdings, deposits, withdrawals;
+        in.read(reinterpret_cast<char*>(&holdings), sizeof(holdings));
+        in.read(reinterpret_cast<char*>(&deposits), sizeof(deposits));
+        in.read(reinterpret_cast<char*>(&withdrawals), sizeof(withdrawals));
+        setTotalHoldings(holdings);
+        setTotalDeposits(deposits);
+        setTotalWithdrawals(withdrawals);
     }
 
     /**
      * @brief Prints a summary of the bank's financial state.
      *
      * Outputs the starting funds, total deposits, total withdrawals, and total holdings
-     * to the standard output stream in a formatted report.
+     * to the standard output stream in a formatted report, followed by the volume of the
+     * last 24 hours summed from the hourly buckets.
      */
     void BankFunds::printBankReport() const {
         std::cout << "--- Bank Report ---" << std::endl;
         std::cout << std::fixed << std::setprecision(2);
         std::cout << "Starting Funds: $" << startingFunds << std::endl;
-        std::cout << "Total Deposits: $" << totalDeposits << std::endl;
-        std::cout << "Total Withdrawals: $" << totalWithdrawals << std::endl;
-        std::cout << "Total Holdings: $" << totalHoldings << std::endl;
+        std::cout << "Total Deposits: $" << getTotalDeposits() << std::endl;
+        std::cout << "Total Withdrawals: $" << getTotalWithdrawals() << std::endl;
+        std::cout << "Total Holdings: $" << getTotalHoldings() << std::endl;
+
+        std::int64_t depositCents = 0;
+        std::int64_t withdrawalCents = 0;
+        for (const auto& bucket : volume.recent(VolumeRollup::Resolution::Hour, 24, std::time(nullptr))) {
+            depositCents += bucket.depositCents;
+            withdrawalCents += bucket.withdrawalCents;
+        }
+        std::cout << "Last 24 Hours: $" << toDollars(depositCents) << " deposited, $"
+            << toDollars(withdrawalCents) << " withdrawn" << std::endl;
+    }
+
+    /**
+     * @brief Prints deposit and withdrawal volume for the most recent time buckets.
+     *
+     * Prompts for minutes, hours or days and for how many buckets to show, then prints
+     * one line per bucket, oldest first, straight from the rollup.
+     */
+    void BankFunds::printVolumeReport() const {
+        std::cout << "1. By minute (last " << volume.capacity(VolumeRollup::Resolution::Minute) << ")" << std::endl;
+        std::cout << "2. By hour (last " << volume.capacity(VolumeRollup::Resolution::Hour) << ")" << std::endl;
+        std::cout << "3. By day (last " << volume.capacity(VolumeRollup::Resolution::Day) << ")" << std::endl;
+        int selection = numericValidator("Your selection: ", 1, 3);
+        auto resolution = static_cast<VolumeRollup::Resolution>(selection - 1);
+
+        std::size_t count = numericValidator("Buckets to show: ", std::size_t(1), volume.capacity(resolution));
+        std::vector<VolumeRollup::Bucket> buckets = volume.recent(resolution, count, std::time(nullptr));
+
+        std::cout << "--- Transaction Volume ---" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        for (const auto& bucket : buckets) {
+            std::cout << Account::formatTimestamp(bucket.start) << " | "
+                << bucket.deposits << " deposits $" << toDollars(bucket.depositCents) << " | "
+                << bucket.withdrawals << " withdrawals $" << toDollars(bucket.withdrawalCents) << " | "
+                << "net $" << toDollars(bucket.depositCents - bucket.withdrawalCents) << std::endl;
+        }
     }
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #pragma once
+#include <cstdint>
 #include <iostream>
 #include <fstream>
+#include "ShardedCounter.h"
+#include "VolumeRollup.h"
 
 namespace bankSimulation {
 
@@ -10,16 +13,40 @@ namespace bankSimulation {
      *
      * This class stores and tracks aggregate financial statistics used in reporting and administrative tasks.
      * It also includes support for binary serialization and deserialization of its internal state.
+     *
+     * The running totals are kept as whole cents in ShardedCounters, so concurrent deposits and
+     * withdrawals update them without a lock or a shared cache line, and the totals always
+     * reconcile exactly. Readers fold the shards together.
+     *
+     * Each deposit and withdrawal is also added to per-minute, per-hour and per-day volume
+     * buckets, so recent activity can be reported without reading any account history.
      */
     class BankFunds {
     private:
         double startingFunds = 15'000'000.00;   ///< Initial seed capital of the bank
         std::string password = "ShowMeTheMoney"; ///< Password for employee access
-        double totalHoldings = 15'000'000.00;   ///< Current total funds held by the bank
-        double totalDeposits = 0.0;             ///< Total of all deposits made
-        double totalWithdrawals = 0.0;          ///< Total of all withdrawals made
+        ShardedCounter totalHoldings{ 1'500'000'000 };  ///< Current total funds held by the bank, in cents
+        ShardedCounter totalDeposits;                   ///< Total of all deposits made, in cents
+        ShardedCounter totalWithdrawals;                ///< Total of all withdrawals made, in cents
+        VolumeRollup volume;                            ///< Recent deposit and withdrawal volume by time bucket
 
     public:
+        /**
+         * @brief Atomically adds a deposit to the total deposits and holdings.
+         *
+         * @param amount Deposited amount.
+         * @param when Time of the deposit, in seconds since the epoch, for the volume buckets.
+         */
+        void recordDeposit(double amount, std::int64_t when);
+
+        /**
+         * @brief Atomically adds a withdrawal to the total withdrawals and removes it from holdings.
+         *
+         * @param amount Withdrawn amount.
+         * @param when Time of the withdrawal, in seconds since the epoch, for the volume buckets.
+         */
+        void recordWithdrawal(double amount, std::int64_t when);
+
         /**
          * @brief Updates the total holdings value.
          *
@@ -72,6 +99,20 @@ namespace bankSimulation {
          */
         double getTotalWithdrawals() const;
 
+        /**
+         * @brief Gets the recent deposit and withdrawal volume by time bucket.
+         *
+         * @return The volume rollup.
+         */
+        VolumeRollup& getVolume();
+
+        /**
+         * @brief Gets the recent deposit and withdrawal volume by time bucket.
+         *
+         * @return The volume rollup.
+         */
+        const VolumeRollup& getVolume() const;
+
         /**
          * @brief Serializes the bank fund data to a binary output stream.
          *
@@ -90,6 +131,11 @@ namespace bankSimulation {
          * @brief Prints a formatted report of the banks financial summary.
          */
         void printBankReport() const;
+
+        /**
+         * @brief Prompts for a resolution and bucket count, then prints the recent volume series.
+         */
+        void printVolumeReport() const;
     };
 
 }
\ No newline at end of file
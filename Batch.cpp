@@ -0,0 +1,365 @@
+#include "Batch.h"
+#include "Account.h"
+#include "BankFunds.h"
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace bankSimulation {
+    namespace {
+        /// Marks a binary batch file
+        const char binaryMagic[4] = { 'L', 'B', 'T', 'X' };
+
+        /**
+         * @brief Applies one parsed record and counts its outcome.
+         *
+         * @param storage Storage holding the accounts.
+         * @param bank Bank totals to update.
+         * @param accountNumber Target account.
+         * @param type 'D' for deposit, 'W' for withdrawal.
+         * @param amount Amount of the transaction.
+         * @param report Report to update.
+         */
+        void applyRecord(Storage& storage, BankFunds& bank, unsigned accountNumber, char type, double amount,
+            BatchReport& report) {
+            Storage::AccountHandle handle = storage.findByAccountNumber(accountNumber);
+            if (handle == Storage::noAccount) {
+                ++report.unknownAccounts;
+                return;
+            }
+
+            Account& acc = storage.getAccount(handle);
+            Account::TransactionResult result = (type == 'D')
+                ? acc.applyDeposit(amount, bank, storage)
+                : acc.applyWithdrawal(amount, bank, storage);
+
+            switch (result) {
+            case Account::TransactionResult::Applied:
+                ++(type == 'D' ? report.deposits : report.withdrawals);
+                break;
+            case Account::TransactionResult::InsufficientFunds:
+                ++report.insufficientFunds;
+                break;
+            case Account::TransactionResult::InvalidAmount:
+                ++report.invalidAmounts;
+                break;
+            case Account::TransactionResult::UnknownAccount:
+                ++report.unknownAccounts;
+                break;
+            }
+        }
+
+        /**
+         * @brief Normalizes a transaction type field to 'D' or 'W'.
+         * @param field Type as written in the CSV file.
+         * @return 'D', 'W', or 0 if the field is not a known type.
+         */
+        char parseType(const std::string& field) {
+            if (field == "D" || field == "d" || field == "Deposit" || field == "deposit") {
+                return 'D';
+            }
+            if (field == "W" || field == "w" || field == "Withdrawal" || field == "withdrawal") {
+                return 'W';
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Reads CSV records line by line and applies each one.
+         * @param in Stream positioned at the start of the file.
+         * @param storage Storage holding the accounts.
+         * @param bank Bank totals to update.
+         * @param report Report to update.
+         */
+        void runCsv(std::istream& in, Storage& storage, BankFunds& bank, BatchReport& report) {
+            std::string line;
+            bool firstLine = true;
+
+            while (std::getline(in, line)) {
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                if (line.empty() || line[0] == '#') {
+                    continue;
+                }
+
+                std::size_t firstComma = line.find(',');
+                std::size_t secondComma = firstComma == std::string::npos ? firstComma : line.find(',', firstComma + 1);
+
+                // A first line that does not start with a number is a column header
+                bool numeric = std::isdigit(static_cast<unsigned char>(line[0])) != 0;
+                if (firstLine && !numeric) {
+                    firstLine = false;
+                    continue;
+                }
+                firstLine = false;
+                ++report.recordsRead;
+
+                if (secondComma == std::string::npos || !numeric) {
+                    ++report.malformed;
+                    continue;
+                }
+
+                char* end = nullptr;
+                unsigned long accountNumber = std::strtoul(line.c_str(), &end, 10);
+                if (end != line.c_str() + firstComma) {
+                    ++report.malformed;
+                    continue;
+                }
+
+                char type = parseType(line.substr(firstComma + 1, secondComma - firstComma - 1));
+                const char* amountText = line.c_str() + secondComma + 1;
+                double amount = std::strtod(amountText, &end);
+                if (type == 0 || end == amountText || *end != '\0') {
+                    ++report.malformed;
+                    continue;
+                }
+
+                applyRecord(storage, bank, static_cast<unsigned>(accountNumber), type, amount, report);
+            }
+        }
+
+        /**
+         * @brief Reads fixed-size binary records and applies each one.
+         * @param in Stream positioned just after the magic bytes.
+         * @param storage Storage holding the accounts.
+         * @param bank Bank totals to update.
+         * @param report Report to update.
+         */
+        void runBinary(std::istream& in, Storage& storage, BankFunds& bank, BatchReport& report) {
+            std::uint32_t accountNumber;
+            char type;
+            double amount;
+
+            while (in.read(reinterpret_cast<char*>(&accountNumber), sizeof(accountNumber))) {
+                in.read(&type, sizeof(type));
+                in.read(reinterpret_cast<char*>(&amount), sizeof(amount));
+                ++report.recordsRead;
+
+                if (!in || (type != 'D' && type != 'W')) {
+                    ++report.malformed;
+                    continue;
+                }
+
+                applyRecord(storage, bank, accountNumber, type, amount, report);
+            }
+        }
+    }
+
+    /**
+     * @brief Applies a CSV or binary transaction file to the loaded accounts.
+     *
+     * Detects the format from the first four bytes, applies every record inside a
+     * Storage batch, and ends the batch so that everything is persisted once.
+     *
+     * @param storage Loaded storage to apply the batch to.
+     * @param path Batch file to read.
+     * @param report Filled in with the outcome of every record.
+     * @return False if the file could not be opened or bank funds are missing.
+     */
+    bool runBatch(Storage& storage, const std::string& path, BatchReport& report) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            std::cerr << "Error opening batch file " << path << "." << std::endl;
+            return false;
+        }
+
+        if (storage.getFunds().empty()) {
+            std::cerr << "Bank funds are not initialized." << std::endl;
+            return false;
+        }
+        BankFunds& bank = storage.getFunds()[0];
+
+        auto start = std::chrono::steady_clock::now();
+        storage.beginBatch();
+
+        char magic[sizeof(binaryMagic)] = {};
+        in.read(magic, sizeof(magic));
+        if (in && std::memcmp(magic, binaryMagic, sizeof(binaryMagic)) == 0) {
+            runBinary(in, storage, bank, report);
+        }
+        else {
+            in.clear();
+            in.seekg(0);
+            runCsv(in, storage, bank, report);
+        }
+
+        storage.endBatch();
+        report.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return true;
+    }
+
+    /**
+     * @brief Prints counts, rejects, and throughput of a batch run.
+     * @param report Report filled in by runBatch.
+     */
+    void printBatchReport(const BatchReport& report) {
+        std::size_t applied = report.deposits + report.withdrawals;
+        std::size_t rejected = report.malformed + report.unknownAccounts + report.invalidAmounts;
+
+        std::cout << "--- Batch Report ---" << std::endl;
+        std::cout << "Records read: " << report.recordsRead << std::endl;
+        std::cout << "Deposits applied: " << report.deposits << std::endl;
+        std::cout << "Withdrawals applied: " << report.withdrawals << std::endl;
+        std::cout << "Insufficient funds: " << report.insufficientFunds << std::endl;
+        std::cout << "Rejected: " << rejected
+            << " (malformed " << report.malformed
+            << ", unknown account " << report.unknownAccounts
+            << ", invalid amount " << report.invalidAmounts << ")" << std::endl;
+        std::cout << std::fixed << std::setprecision(3);
+        std::cout << "Elapsed: " << report.seconds << " s" << std::endl;
+        std::cout << std::setprecision(0);
+        std::cout << "Throughput: " << (report.seconds > 0.0 ? applied / report.seconds : 0.0)
+            << " transactions/s" << std::endl;
+    }
+
+    /**
+     * @brief Checks that a batch stopped halfway can be applied again from the start.
+     *
+     * The interrupted run keeps a 1 ms checkpoint period and pauses after every
+     * thousand records, so the Checkpointer has every chance to write part of the
+     * batch. Amounts are compared in cents.
+     *
+     * @param accountCount Accounts in the generated book.
+     * @param recordCount Records in the generated batch.
+     * @param directory Scratch directory for the data files; created if missing.
+     * @return True if the re-applied batch matches, false on a mismatch or setup error.
+     */
+    bool runBatchRecoveryCheck(std::size_t accountCount, std::size_t recordCount, const std::string& directory) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            std::cerr << "Cannot create check directory " << directory << ": " << error.message() << std::endl;
+            return false;
+        }
+        for (const char* name : { "accounts.dat", "accounts.dat.tmp", "funds.dat", "funds.dat.tmp", "journal.dat", "journal.dat.sealed" }) {
+            std::filesystem::remove(std::filesystem::path(directory) / name, error);
+        }
+
+        const unsigned firstAccount = 10'000;
+        {
+            Storage storage(directory);
+            storage.getFunds().push_back(BankFunds());
+            for (std::size_t i = 0; i < accountCount; ++i) {
+                Account account;
+                account.setHolderFirstName("Batch");
+                account.setHolderLastName("Check");
+                account.setHolderAccountNumber(firstAccount + static_cast<unsigned>(i));
+                account.setHolderPassword("Batch#123");
+                account.setBalance(100.00);
+                storage.addAccount(std::move(account));
+            }
+            storage.checkpoint();
+        }
+
+        struct Record {
+            std::uint32_t accountNumber;
+            char type;
+            double amount;
+        };
+        std::vector<Record> records(recordCount);
+        std::mt19937 random(11);
+        std::uniform_int_distribution<std::size_t> pickIndex(0, accountCount > 0 ? accountCount - 1 : 0);
+        std::uniform_int_distribution<int> pickCents(1, 20'000);
+        for (auto& record : records) {
+            record.accountNumber = firstAccount + static_cast<std::uint32_t>(pickIndex(random));
+            record.type = random() % 2 == 0 ? 'D' : 'W';
+            record.amount = pickCents(random) / 100.0;
+        }
+
+        std::string batchPath = (std::filesystem::path(directory) / "batch-check.bin").string();
+        {
+            std::ofstream out(batchPath, std::ios::binary);
+            out.write(binaryMagic, sizeof(binaryMagic));
+            for (const auto& record : records) {
+                out.write(reinterpret_cast<const char*>(&record.accountNumber), sizeof(record.accountNumber));
+                out.write(&record.type, sizeof(record.type));
+                out.write(reinterpret_cast<const char*>(&record.amount), sizeof(record.amount));
+            }
+            if (!out) {
+                std::cerr << "Error writing " << batchPath << "." << std::endl;
+                return false;
+            }
+        }
+
+        // Balances and totals in cents, in handle order, followed by deposits and withdrawals
+        auto centsOf = [](Storage& storage) {
+            std::vector<std::int64_t> cents;
+            for (const auto& acc : storage.getAccounts()) {
+                cents.push_back(std::llround(acc.getBalance() * 100.0));
+            }
+            cents.push_back(std::llround(storage.getFunds()[0].getTotalDeposits() * 100.0));
+            cents.push_back(std::llround(storage.getFunds()[0].getTotalWithdrawals() * 100.0));
+            return cents;
+        };
+
+        // The batch applied once, in memory only
+        std::vector<std::int64_t> expected;
+        BatchReport report;
+        {
+            Storage storage(directory);
+            storage.loadBank();
+            storage.loadAccount();
+            storage.beginBatch();
+            for (const auto& record : records) {
+                applyRecord(storage, storage.getFunds()[0], record.accountNumber, record.type, record.amount, report);
+            }
+            expected = centsOf(storage);
+        }
+
+        // Half the batch with the Checkpointer running, then dropped without endBatch
+        {
+            Storage storage(directory);
+            storage.loadBank();
+            storage.loadAccount();
+            storage.setCheckpointPeriod(std::chrono::milliseconds(1));
+            storage.beginBatch();
+            for (std::size_t i = 0; i < records.size() / 2; ++i) {
+                applyRecord(storage, storage.getFunds()[0], records[i].accountNumber, records[i].type, records[i].amount, report);
+                if (i % 1'000 == 999) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                }
+            }
+        }
+
+        // The recovery: the whole batch applied again
+        {
+            Storage storage(directory);
+            storage.loadBank();
+            storage.loadAccount();
+            storage.setCheckpointPeriod(std::chrono::milliseconds(1));
+            report = BatchReport();
+            if (!runBatch(storage, batchPath, report)) {
+                return false;
+            }
+        }
+
+        Storage reloaded(directory);
+        reloaded.loadBank();
+        reloaded.loadAccount();
+        std::vector<std::int64_t> actual = centsOf(reloaded);
+        std::filesystem::remove(batchPath, error);
+
+        std::size_t mismatched = 0;
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            mismatched += i >= actual.size() || actual[i] != expected[i];
+        }
+        if (mismatched > 0 || actual.size() != expected.size()) {
+            std::cout << "Re-applied batch differs from a single run in " << mismatched << " of " << expected.size()
+                << " balances and totals." << std::endl;
+            return false;
+        }
+        std::cout << "Re-applied batch matches a single run." << std::endl;
+        return true;
+    }
+}
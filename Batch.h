@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "Storage.h"
+
+namespace bankSimulation {
+
+	/**
+	 * @struct BatchReport
+	 * @brief Summary of one batch ingestion run.
+	 */
+	struct BatchReport {
+		std::size_t recordsRead = 0;        ///< Records found in the input
+		std::size_t deposits = 0;           ///< Deposits applied
+		std::size_t withdrawals = 0;        ///< Withdrawals applied
+		std::size_t malformed = 0;          ///< Records that could not be parsed
+		std::size_t unknownAccounts = 0;    ///< Records for account numbers that do not exist
+		std::size_t invalidAmounts = 0;     ///< Records with an amount outside the allowed range
+		std::size_t insufficientFunds = 0;  ///< Withdrawals larger than the balance
+		double seconds = 0.0;               ///< Time spent applying and persisting the batch
+	};
+
+	/**
+	 * @brief Applies a file of transactions without any console interaction.
+	 *
+	 * The file is either CSV text, one "account number,type,amount" record per line with
+	 * type D/Deposit or W/Withdrawal (a header line and lines starting with '#' are
+	 * skipped), or binary: the four bytes "LBTX" followed by records of a 4-byte account
+	 * number, a 1-byte 'D' or 'W', and an 8-byte amount.
+	 *
+	 * Each record goes through Account::applyDeposit or Account::applyWithdrawal, so the
+	 * balance and BankFunds updates match the interactive menus. Storage persists once,
+	 * at the end of the batch.
+	 *
+	 * @param storage Loaded storage to apply the batch to.
+	 * @param path Batch file to read.
+	 * @param report Filled in with the outcome of every record.
+	 * @return False if the file could not be opened.
+	 */
+	bool runBatch(Storage& storage, const std::string& path, BatchReport& report);
+
+	/**
+	 * @brief Prints counts, rejects, and throughput of a batch run.
+	 * @param report Report filled in by runBatch.
+	 */
+	void printBatchReport(const BatchReport& report);
+
+	/**
+	 * @brief Checks that a batch stopped halfway can be applied again from the start.
+	 *
+	 * Builds a book in its own directory and writes a binary batch for it. Applies half
+	 * the batch while background checkpoints run, then drops the Storage without ending
+	 * the batch, as a process killed mid-batch would. Reloads, applies the whole batch
+	 * again, reloads once more, and compares every balance and the bank totals with the
+	 * batch applied once to the original book.
+	 *
+	 * @param accountCount Accounts in the generated book.
+	 * @param recordCount Records in the generated batch.
+	 * @param directory Scratch directory for the data files; created if missing.
+	 * @return True if the re-applied batch matches, false on a mismatch or setup error.
+	 */
+	bool runBatchRecoveryCheck(std::size_t accountCount, std::size_t recordCount, const std::string& directory);
+}
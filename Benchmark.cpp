@@ -0,0 +1,440 @@
+#include "Benchmark.h"
+#include "Account.h"
+#include "BankFunds.h"
+#include "Storage.h"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <random>
+#include <vector>
+
+namespace bankSimulation {
+    namespace {
+        /// Lookups and transactions timed at every account count
+        const std::size_t lookupOperations = 200'000;
+
+        /// Filtered account queries and leaderboard lookups timed at every account count
+        const std::size_t queryOperations = 20'000;
+
+        /// Accounts used for the logTransaction measurements
+        const std::size_t historyAccounts = 100;
+
+        /// Transactions given to every generated account, so saves and loads carry histories
+        const int seededTransactions = 2;
+
+        /// Distinct last names; larger books share names the way real ones do
+        const std::size_t lastNamePool = 50'000;
+
+        /**
+         * @brief Times a piece of work.
+         * @param work Work to run once.
+         * @return Elapsed seconds.
+         */
+        template <typename Work>
+        double timeIt(Work work) {
+            auto start = std::chrono::steady_clock::now();
+            work();
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        /**
+         * @brief Writes one CSV result row.
+         *
+         * @param out Stream receiving the row.
+         * @param name Benchmark name.
+         * @param accounts Number of accounts in the book.
+         * @param operations Number of timed operations.
+         * @param seconds Elapsed seconds for all operations.
+         */
+        void report(std::ostream& out, const char* name, std::size_t accounts, std::size_t operations, double seconds) {
+            out << name << "," << accounts << "," << operations << "," << seconds << ","
+                << (operations > 0 ? seconds * 1e9 / operations : 0.0) << std::endl;
+        }
+
+        /**
+         * @brief Gets the generated last name for an account index.
+         * @param index Position of the account in the book.
+         * @return Last name.
+         */
+        std::string lastNameFor(std::size_t index) {
+            return "Holder" + std::to_string(index % lastNamePool);
+        }
+
+        /**
+         * @brief Fills a storage with generated accounts, each carrying a short history.
+         *
+         * @param storage Empty storage to fill.
+         * @param count Number of accounts to create.
+         */
+        void populate(Storage& storage, std::size_t count) {
+            storage.getAccounts().reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                Account account;
+                account.setHolderFirstName("Bench");
+                account.setHolderLastName(lastNameFor(i));
+                account.setHolderAccountNumber(static_cast<unsigned>(10'000 + i));
+                account.setHolderPassword("Bench#123");
+                account.setBalance(1'000.00);
+                for (int t = 0; t < seededTransactions; ++t) {
+                    account.recordTransaction(Account::TransactionType::Deposit, 500.00, 1'000.00, 1'700'000'000 + t);
+                }
+                storage.addAccount(std::move(account));
+            }
+        }
+
+        /**
+         * @brief Measures logTransaction on histories that have room, then on full ones.
+         *
+         * Also times time-range and most-recent lookups on one wrapped, full history.
+         *
+         * @param out Stream receiving the CSV results.
+         */
+        void benchmarkLogTransaction(std::ostream& out) {
+            Storage storage;
+            storage.getFunds().push_back(BankFunds());
+            storage.beginBatch();
+
+            std::vector<Account> accounts(historyAccounts);
+            for (std::size_t i = 0; i < accounts.size(); ++i) {
+                accounts[i].setHolderAccountNumber(static_cast<unsigned>(10'000 + i));
+                accounts[i].setBalance(0.0);
+            }
+            const std::size_t perAccount = 900;
+
+            double growing = timeIt([&]() {
+                for (std::size_t i = 0; i < perAccount; ++i) {
+                    for (auto& acc : accounts) {
+                        acc.logTransaction(Account::TransactionType::Deposit, 10.00, 10.00, storage);
+                    }
+                }
+            });
+            report(out, "log_transaction_with_room", historyAccounts, historyAccounts * perAccount, growing);
+
+            // Top every history up to its limit, so each new entry overwrites the oldest
+            for (auto& acc : accounts) {
+                while (acc.getTransactionCount() < Account::maxTransactions) {
+                    acc.logTransaction(Account::TransactionType::Deposit, 10.00, 10.00, storage);
+                }
+            }
+
+            double full = timeIt([&]() {
+                for (std::size_t i = 0; i < perAccount; ++i) {
+                    for (auto& acc : accounts) {
+                        acc.logTransaction(Account::TransactionType::Deposit, 10.00, 10.00, storage);
+                    }
+                }
+            });
+            report(out, "log_transaction_full_history", historyAccounts, historyAccounts * perAccount, full);
+
+            // Spread a full history over a day, so range queries land anywhere in the wrapped buffer
+            Account spread;
+            for (int t = 0; t < Account::maxTransactions + Account::maxTransactions / 3; ++t) {
+                spread.recordTransaction(Account::TransactionType::Deposit, 10.00, 10.00, 1'700'000'000 + t * 60);
+            }
+            std::int64_t oldest = spread.getTransaction(0).timestamp;
+            std::int64_t newest = spread.getTransaction(spread.getTransactionCount() - 1).timestamp;
+            std::mt19937 random(7);
+            std::uniform_int_distribution<std::int64_t> pickTime(oldest, newest);
+            const std::size_t rangeQueries = 200'000;
+            std::size_t found = 0;
+
+            double between = timeIt([&]() {
+                for (std::size_t i = 0; i < rangeQueries; ++i) {
+                    std::int64_t from = pickTime(random);
+                    Account::TransactionRange range = spread.transactionsBetween(from, from + 3'600);
+                    found += range.last - range.first;
+                }
+            });
+            report(out, "history_between", 1, rangeQueries, between);
+
+            double recent = timeIt([&]() {
+                for (std::size_t i = 0; i < rangeQueries; ++i) {
+                    Account::TransactionRange range = spread.lastTransactions(static_cast<int>(i % 50) + 1);
+                    found += range.last - range.first;
+                }
+            });
+            report(out, "history_last_k", 1, rangeQueries, recent);
+            if (found == 0) {
+                std::cerr << "history benchmarks matched no transactions." << std::endl;
+            }
+        }
+
+        /**
+         * @brief Measures journaled deposits and withdrawals under each durability mode.
+         *
+         * Uses a small book and no automatic checkpoints, so the rows show only the cost
+         * of getting each record into the journal. The Async row is the time the teller
+         * waits; the records are written after the loop.
+         *
+         * @param directory Scratch directory for the data files.
+         * @param out Stream receiving the CSV results.
+         */
+        void benchmarkDurability(const std::string& directory, std::ostream& out) {
+            const std::size_t accountCount = 1'000;
+            const std::size_t transactions = 20'000;
+
+            Storage storage(directory);
+            storage.getFunds().push_back(BankFunds());
+            populate(storage, accountCount);
+            storage.setCheckpointInterval(static_cast<std::size_t>(-1));
+            BankFunds& bank = storage.getFunds()[0];
+            std::mt19937 random(3);
+            std::uniform_int_distribution<std::size_t> pickIndex(0, accountCount - 1);
+
+            const std::pair<PersistenceWorker::Durability, const char*> modes[] = {
+                { PersistenceWorker::Durability::Sync, "journaled_transaction_sync" },
+                { PersistenceWorker::Durability::GroupCommit, "journaled_transaction_group" },
+                { PersistenceWorker::Durability::Async, "journaled_transaction_async" },
+            };
+            for (const auto& mode : modes) {
+                storage.setDurability(mode.first);
+                double seconds = timeIt([&]() {
+                    for (std::size_t i = 0; i < transactions; ++i) {
+                        Account& acc = storage.getAccount(pickIndex(random));
+                        if (i % 2 == 0) {
+                            acc.applyDeposit(25.00, bank, storage);
+                        }
+                        else {
+                            acc.applyWithdrawal(25.00, bank, storage);
+                        }
+                    }
+                });
+                report(out, mode.second, accountCount, transactions, seconds);
+            }
+            storage.setDurability(PersistenceWorker::Durability::Sync);
+
+            // The per-size books reuse the directory and must not replay these records
+            std::error_code error;
+            std::filesystem::remove(std::filesystem::path(directory) / "journal.dat", error);
+            std::filesystem::remove(std::filesystem::path(directory) / "journal.dat.sealed", error);
+        }
+
+        /**
+         * @brief Measures transactions while checkpoints are written inline, then in the background.
+         *
+         * Checkpoints every checkpointInterval records, as a busy teller would. The
+         * transaction rows compare what the tellers wait for; the checkpoint rows show how
+         * long the background checkpoints took and how much of that held transactions off.
+         *
+         * @param directory Scratch directory for the data files.
+         * @param out Stream receiving the CSV results.
+         */
+        void benchmarkCheckpoints(const std::string& directory, std::ostream& out) {
+            const std::size_t accountCount = 10'000;
+            const std::size_t transactions = 100'000;
+            const std::size_t interval = 5'000;
+
+            Storage storage(directory);
+            storage.getFunds().push_back(BankFunds());
+            populate(storage, accountCount);
+            storage.setDurability(PersistenceWorker::Durability::Async);
+            storage.checkpoint();
+            storage.setCheckpointInterval(interval);
+            BankFunds& bank = storage.getFunds()[0];
+            std::mt19937 random(5);
+            std::uniform_int_distribution<std::size_t> pickIndex(0, accountCount - 1);
+
+            auto run = [&]() {
+                for (std::size_t i = 0; i < transactions; ++i) {
+                    Account& acc = storage.getAccount(pickIndex(random));
+                    if (i % 2 == 0) {
+                        acc.applyDeposit(25.00, bank, storage);
+                    }
+                    else {
+                        acc.applyWithdrawal(25.00, bank, storage);
+                    }
+                }
+            };
+            report(out, "transaction_inline_checkpoint", accountCount, transactions, timeIt(run));
+
+            // A long period, so only the interval triggers checkpoints
+            storage.setCheckpointPeriod(std::chrono::hours(1));
+            report(out, "transaction_background_checkpoint", accountCount, transactions, timeIt(run));
+            storage.setCheckpointPeriod(std::chrono::milliseconds(0));
+
+            CheckpointReport last;
+            CheckpointReport totals;
+            std::uint64_t written = storage.getCheckpointReports(last, totals);
+            report(out, "checkpoint_pause", accountCount, static_cast<std::size_t>(written), totals.pauseSeconds);
+            report(out, "background_checkpoint", accountCount, static_cast<std::size_t>(written), totals.seconds);
+
+            storage.setDurability(PersistenceWorker::Durability::Sync);
+
+            // The per-size books start from an empty directory
+            std::error_code error;
+            for (const char* name : { "accounts.dat", "funds.dat", "journal.dat", "journal.dat.sealed" }) {
+                std::filesystem::remove(std::filesystem::path(directory) / name, error);
+            }
+        }
+
+        /**
+         * @brief Runs every per-size measurement for one account count.
+         *
+         * @param count Number of accounts.
+         * @param directory Scratch directory for the data files.
+         * @param out Stream receiving the CSV results.
+         */
+        void benchmarkBook(std::size_t count, const std::string& directory, std::ostream& out) {
+            std::mt19937 random(static_cast<unsigned>(count));
+            std::uniform_int_distribution<std::size_t> pickIndex(0, count - 1);
+
+            {
+                Storage storage(directory);
+                storage.getFunds().push_back(BankFunds());
+                double created = timeIt([&]() { populate(storage, count); });
+                report(out, "create_accounts", count, count, created);
+
+                // The logic behind the interactive deposit and withdrawal prompts, without journaling
+                storage.beginBatch();
+                BankFunds& bank = storage.getFunds()[0];
+                double applied = timeIt([&]() {
+                    for (std::size_t i = 0; i < lookupOperations; ++i) {
+                        Account& acc = storage.getAccount(pickIndex(random));
+                        if (i % 2 == 0) {
+                            acc.applyDeposit(25.00, bank, storage);
+                        }
+                        else {
+                            acc.applyWithdrawal(25.00, bank, storage);
+                        }
+                    }
+                });
+                report(out, "apply_deposit_withdrawal", count, lookupOperations, applied);
+
+                // userLogIn: find the first account with the last name, then check the password
+                std::size_t loggedIn = 0;
+                double login = timeIt([&]() {
+                    for (std::size_t i = 0; i < lookupOperations; ++i) {
+                        const Storage::HandleList& matches = storage.findByLastName(storage.findLastNameId(lastNameFor(pickIndex(random))));
+                        if (!matches.empty() && storage.getAccount(matches.front()).getHolderPassword() == "Bench#123") {
+                            ++loggedIn;
+                        }
+                    }
+                });
+                report(out, "login_lookup", count, lookupOperations, login);
+                if (loggedIn != lookupOperations) {
+                    std::cerr << "login_lookup missed " << lookupOperations - loggedIn << " accounts." << std::endl;
+                }
+
+                // searchAccounts by account number and by last name, without the prompts
+                std::size_t found = 0;
+                double byNumber = timeIt([&]() {
+                    for (std::size_t i = 0; i < lookupOperations; ++i) {
+                        unsigned accountNumber = static_cast<unsigned>(10'000 + pickIndex(random));
+                        found += storage.findByAccountNumber(accountNumber) != Storage::noAccount;
+                    }
+                });
+                report(out, "search_by_account_number", count, lookupOperations, byNumber);
+
+                double byName = timeIt([&]() {
+                    for (std::size_t i = 0; i < lookupOperations; ++i) {
+                        found += storage.findByLastName(storage.findLastNameId(lastNameFor(pickIndex(random)))).size();
+                    }
+                });
+                report(out, "search_by_last_name", count, lookupOperations, byName);
+                if (found < 2 * lookupOperations) {
+                    std::cerr << "search benchmarks missed accounts." << std::endl;
+                }
+
+                // Employee queries: a $1 balance window and a last name prefix, 20 results each
+                AccountQuery query;
+                query.limit = 20;
+                std::uniform_real_distribution<double> pickBalance(900.00, 1'100.00);
+                double byBalance = timeIt([&]() {
+                    for (std::size_t i = 0; i < queryOperations; ++i) {
+                        query.minBalance = pickBalance(random);
+                        query.maxBalance = *query.minBalance + 1.00;
+                        found += storage.findAccounts(query).size();
+                    }
+                });
+                report(out, "query_balance_range", count, queryOperations, byBalance);
+
+                query.minBalance.reset();
+                query.maxBalance.reset();
+                double byPrefix = timeIt([&]() {
+                    for (std::size_t i = 0; i < queryOperations; ++i) {
+                        query.lastNamePrefix = lastNameFor(pickIndex(random)).substr(0, 9);
+                        found += storage.findAccounts(query).size();
+                    }
+                });
+                report(out, "query_last_name_prefix", count, queryOperations, byPrefix);
+
+                double top = timeIt([&]() {
+                    for (std::size_t i = 0; i < queryOperations; ++i) {
+                        found += storage.largestAccounts(10).size();
+                    }
+                });
+                report(out, "leaderboard_top_10", count, queryOperations, top);
+
+                double ranked = timeIt([&]() {
+                    for (std::size_t i = 0; i < queryOperations; ++i) {
+                        found += storage.balanceRank(static_cast<Storage::AccountHandle>(pickIndex(random)));
+                    }
+                });
+                report(out, "balance_rank", count, queryOperations, ranked);
+
+                double saved = timeIt([&]() { storage.saveAccount(); });
+                report(out, "save_accounts", count, count, saved);
+
+                // Change one account in a hundred; the next save writes only their records
+                std::size_t touched = std::max<std::size_t>(count / 100, 1);
+                for (std::size_t i = 0; i < touched; ++i) {
+                    storage.getAccount(pickIndex(random)).applyDeposit(25.00, bank, storage);
+                }
+                double incremental = timeIt([&]() { storage.saveAccount(); });
+                report(out, "save_accounts_incremental", count, touched, incremental);
+            }
+
+            {
+                Storage storage(directory);
+                double loaded = timeIt([&]() { storage.loadAccount(); });
+                report(out, "load_accounts", count, count, loaded);
+            }
+
+            {
+                Storage storage(directory);
+                storage.setLoadThreads(1);
+                double loaded = timeIt([&]() { storage.loadAccount(); });
+                report(out, "load_accounts_single_thread", count, count, loaded);
+            }
+
+            {
+                Storage storage(directory);
+                storage.setLazyHistory(true, 64 * 1024 * 1024);
+                double loaded = timeIt([&]() { storage.loadAccount(); });
+                report(out, "load_accounts_lazy", count, count, loaded);
+            }
+        }
+    }
+
+    /**
+     * @brief Times the core banking paths at growing account counts.
+     *
+     * Status messages from Storage go to std::cout, so the CSV should be sent to a
+     * separate stream (such as a file) when it is parsed by other tools.
+     *
+     * @param maxAccounts Largest account count to measure.
+     * @param directory Scratch directory for the data files; created if missing.
+     * @param out Stream receiving the CSV results.
+     * @return False if the scratch directory could not be prepared.
+     */
+    bool runBenchmarks(std::size_t maxAccounts, const std::string& directory, std::ostream& out) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            std::cerr << "Cannot create benchmark directory " << directory << ": " << error.message() << std::endl;
+            return false;
+        }
+        for (const char* name : { "accounts.dat", "accounts.dat.tmp", "funds.dat", "funds.dat.tmp", "journal.dat", "journal.dat.sealed" }) {
+            std::filesystem::remove(std::filesystem::path(directory) / name, error);
+        }
+
+        out << "benchmark,accounts,operations,seconds,ns_per_op" << std::endl;
+        benchmarkLogTransaction(out);
+        benchmarkDurability(directory, out);
+        benchmarkCheckpoints(directory, out);
+        for (std::size_t count = 1'000; count <= maxAccounts; count *= 10) {
+            benchmarkBook(count, directory, out);
+        }
+        return true;
+    }
+}
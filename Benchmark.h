@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+namespace bankSimulation {
+
+	/**
+	 * @brief Times the core banking paths at growing account counts.
+	 *
+	 * For every size from 1,000 accounts up to maxAccounts (growing tenfold) it measures
+	 * applying deposits and withdrawals, login and search lookups, filtered account queries,
+	 * balance leaderboard and rank lookups, saving accounts.dat in full and again after a
+	 * few accounts changed, and loading it back eagerly (with every core and with one
+	 * thread) and lazily. logTransaction is measured once with histories that still have
+	 * room and once with full histories, history range lookups are measured on a full
+	 * history, journaled transactions are measured under each durability mode, and
+	 * transactions are timed again while checkpoints are written inline and in the
+	 * background, along with how long the background ones held transactions off. The
+	 * data files are written to their own directory, so the bank's real files are never
+	 * touched.
+	 *
+	 * Results are written as CSV with one row per measurement:
+	 * benchmark,accounts,operations,seconds,ns_per_op
+	 *
+	 * @param maxAccounts Largest account count to measure.
+	 * @param directory Scratch directory for the data files; created if missing.
+	 * @param out Stream receiving the CSV results.
+	 * @return False if the scratch directory could not be prepared.
+	 */
+	bool runBenchmarks(std::size_t maxAccounts, const std::string& directory, std::ostream& out);
+}
@@ -0,0 +1,134 @@
+#include "Checkpointer.h"
+#include "Storage.h"
+
+namespace bankSimulation {
+
+    /**
+     * @brief Creates a checkpointer whose thread starts with start().
+     * @param storage Storage to checkpoint.
+     */
+    Checkpointer::Checkpointer(Storage& storage) : storage(storage) {}
+
+    /**
+     * @brief Stops the thread; a checkpoint already running is finished first.
+     */
+    Checkpointer::~Checkpointer() {
+        stop();
+    }
+
+    /**
+     * @brief Waits out the period or a request, writes a checkpoint, and records its report.
+     *
+     * A checkpoint with nothing to write is not counted. Exits once stopping is set.
+     */
+    void Checkpointer::run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait_for(lock, period, [this]() { return stopping || requested.load(); });
+            if (stopping) {
+                return;
+            }
+            requested = false;
+
+            lock.unlock();
+            CheckpointReport report;
+            bool written = storage.backgroundCheckpoint(report);
+            lock.lock();
+
+            if (written) {
+                last = report;
+                totals.seconds += report.seconds;
+                totals.pauseSeconds += report.pauseSeconds;
+                totals.accountsWritten += report.accountsWritten;
+                totals.journalBytesReclaimed += report.journalBytesReclaimed;
+                totals.heapBytesReclaimed += report.heapBytesReclaimed;
+                totals.compacted = totals.compacted || report.compacted;
+                ++count;
+            }
+        }
+    }
+
+    /**
+     * @brief Starts the thread with a period, or restarts it with a new one.
+     * @param newPeriod Longest time between checkpoints; zero or less only stops the thread.
+     */
+    void Checkpointer::start(std::chrono::milliseconds newPeriod) {
+        stop();
+        if (newPeriod.count() <= 0) {
+            return;
+        }
+
+        period = newPeriod;
+        running = true;
+        worker = std::thread(&Checkpointer::run, this);
+    }
+
+    /**
+     * @brief Stops the thread and joins it.
+     */
+    void Checkpointer::stop() {
+        if (!worker.joinable()) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+        stopping = false;
+        running = false;
+    }
+
+    /**
+     * @brief Checks whether the thread is running.
+     * @return True between start() and stop().
+     */
+    bool Checkpointer::isRunning() const {
+        return running.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Wakes the thread early.
+     *
+     * The flag is set before the lock is taken, so the thread either sees it when it
+     * checks its wait condition or is already waiting and gets the notification.
+     */
+    void Checkpointer::request() {
+        if (requested.exchange(true)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+        }
+        wake.notify_one();
+    }
+
+    /**
+     * @brief Gets the report of the most recent checkpoint.
+     * @return Report.
+     */
+    CheckpointReport Checkpointer::getLastReport() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return last;
+    }
+
+    /**
+     * @brief Gets the sum of every checkpoint report.
+     * @return Totals.
+     */
+    CheckpointReport Checkpointer::getTotals() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return totals;
+    }
+
+    /**
+     * @brief Gets the number of checkpoints written.
+     * @return Checkpoint count.
+     */
+    std::uint64_t Checkpointer::getCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return count;
+    }
+}
@@ -0,0 +1,114 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace bankSimulation {
+
+	class Storage;
+
+	/**
+	 * @struct CheckpointReport
+	 * @brief What one checkpoint wrote, what it reclaimed, and how long it took.
+	 */
+	struct CheckpointReport {
+		double seconds = 0;                       ///< Wall time from the capture until the sealed journal was deleted
+		double pauseSeconds = 0;                  ///< Time transactions were held off while the state was captured
+		std::size_t accountsWritten = 0;          ///< Changed and new accounts written
+		std::uint64_t journalBytesReclaimed = 0;  ///< Journal bytes deleted once the checkpoint was durable
+		std::uint64_t heapBytesReclaimed = 0;     ///< accounts.dat bytes left by moved blocks, dropped by a compaction
+		bool compacted = false;                   ///< Whether accounts.dat was rewritten instead of updated in place
+	};
+
+	/**
+	 * @class Checkpointer
+	 * @brief Background thread that writes Storage checkpoints while transactions continue.
+	 *
+	 * Wakes once per period, or early when a transaction finds the journal past the
+	 * checkpoint interval, and calls Storage::backgroundCheckpoint. Keeps the report of
+	 * the last checkpoint and running totals, so the cost of checkpointing can be shown
+	 * without instrumentation.
+	 */
+	class Checkpointer {
+	private:
+		Storage& storage;                          ///< Storage whose state is checkpointed
+
+		std::mutex mutex;                          ///< Guards every member below except the atomics
+		std::condition_variable wake;              ///< Signals the thread that a checkpoint or a stop was requested
+		std::chrono::milliseconds period{ 0 };     ///< Longest time between checkpoints
+		std::atomic<bool> requested{ false };      ///< Set by request() until the thread picks it up
+		std::atomic<bool> running{ false };        ///< Whether the thread is running, read by the transaction path
+		bool stopping = false;                     ///< Set to make the thread exit after the current checkpoint
+		CheckpointReport last;                     ///< Report of the most recent checkpoint
+		CheckpointReport totals;                   ///< Sum of every report
+		std::uint64_t count = 0;                   ///< Checkpoints written
+		std::thread worker;                        ///< Runs run() between start() and stop()
+
+		/**
+		 * @brief Writes checkpoints until asked to stop.
+		 */
+		void run();
+
+	public:
+		/**
+		 * @brief Creates a stopped checkpointer.
+		 * @param storage Storage to checkpoint; must outlive the checkpointer.
+		 */
+		explicit Checkpointer(Storage& storage);
+
+		/**
+		 * @brief Stops the thread, letting a running checkpoint finish.
+		 */
+		~Checkpointer();
+
+		Checkpointer(const Checkpointer&) = delete;
+		Checkpointer& operator=(const Checkpointer&) = delete;
+
+		/**
+		 * @brief Starts the thread, or changes its period if it is running.
+		 * @param period Longest time between checkpoints; zero stops the thread.
+		 */
+		void start(std::chrono::milliseconds period);
+
+		/**
+		 * @brief Stops the thread after any checkpoint in progress.
+		 */
+		void stop();
+
+		/**
+		 * @brief Checks whether the thread is running, without locking.
+		 * @return True between start() and stop().
+		 */
+		bool isRunning() const;
+
+		/**
+		 * @brief Asks for a checkpoint now instead of at the end of the period.
+		 *
+		 * Cheap enough to call after every transaction: only the first call before the
+		 * thread wakes up takes the lock.
+		 */
+		void request();
+
+		/**
+		 * @brief Gets the report of the most recent checkpoint.
+		 * @return Report; all zero before the first checkpoint.
+		 */
+		CheckpointReport getLastReport();
+
+		/**
+		 * @brief Gets the sum of every checkpoint report.
+		 * @return Totals; compacted is set if any checkpoint compacted.
+		 */
+		CheckpointReport getTotals();
+
+		/**
+		 * @brief Gets the number of checkpoints written.
+		 * @return Checkpoint count.
+		 */
+		std::uint64_t getCount();
+	};
+}
@@ -0,0 +1,243 @@
+#include "DatasetGenerator.h"
+#include "Account.h"
+#include "AccountFileWriter.h"
+#include "BankFunds.h"
+#include "Storage.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace bankSimulation {
+    namespace {
+        /// First account number handed out by Storage::newAccount
+        const unsigned firstAccountNumber = 10'000;
+
+        const char* const firstNames[] = {
+            "James", "Mary", "Robert", "Patricia", "John", "Jennifer", "Michael", "Linda", "David", "Elizabeth",
+            "William", "Barbara", "Richard", "Susan", "Joseph", "Jessica", "Thomas", "Sarah", "Charles", "Karen",
+            "Daniel", "Lisa", "Matthew", "Nancy", "Anthony", "Betty", "Mark", "Sandra", "Steven", "Ashley",
+            "Andrew", "Emily", "Joshua", "Donna", "Kevin", "Michelle", "Brian", "Carol", "George", "Amanda"
+        };
+
+        const char* const nameSyllables[] = {
+            "an", "bel", "cor", "dra", "en", "fal", "gor", "hen", "is", "jor", "kin", "lo", "mar",
+            "nes", "or", "pel", "quin", "ros", "sen", "tor", "ul", "var", "wen", "yor", "zan"
+        };
+
+        const char* const nameEndings[] = {
+            "son", "sen", "ton", "ley", "man", "berg", "wood", "ford", "field", "stein",
+            "ez", "ski", "ov", "er", "ins", "well", "worth", "by", "dale", "more"
+        };
+
+        /**
+         * @brief Builds the last name at a position in the name pool.
+         *
+         * The position is spelled out in syllables and given a surname ending, so every
+         * position yields a plausible, reproducible name.
+         *
+         * @param index Position in the pool.
+         * @return Capitalized last name.
+         */
+        std::string makeLastName(std::size_t index) {
+            const std::size_t syllableCount = sizeof(nameSyllables) / sizeof(nameSyllables[0]);
+            const std::size_t endingCount = sizeof(nameEndings) / sizeof(nameEndings[0]);
+
+            std::string name;
+            std::size_t rest = index;
+            do {
+                name += nameSyllables[rest % syllableCount];
+                rest /= syllableCount;
+            } while (rest > 0);
+            name += nameEndings[(index * 7) % endingCount];
+            name[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(name[0])));
+            return name;
+        }
+
+        /**
+         * @brief Draws a whole-cent amount in the allowed transaction range.
+         * @param random Generator to draw from.
+         * @return Amount in cents.
+         */
+        std::int64_t drawCents(std::mt19937_64& random) {
+            std::uniform_int_distribution<std::int64_t> cents(
+                std::llround(Account::minTransactionAmount * 100.0), std::llround(Account::maxTransactionAmount * 100.0));
+            return cents(random);
+        }
+
+        /**
+         * @struct GeneratedTotals
+         * @brief Money moved by the generated transactions.
+         */
+        struct GeneratedTotals {
+            std::int64_t depositedCents = 0;    ///< Sum of all deposits
+            std::int64_t withdrawnCents = 0;    ///< Sum of all withdrawals
+            std::size_t transactions = 0;       ///< Number of transactions
+            VolumeRollup volume;                ///< Recent volume by time bucket
+        };
+
+        /**
+         * @brief Generates every account and hands it to a sink, one at a time.
+         *
+         * Each history is built in cents and converted to dollars only when stored, so
+         * the totals reconcile exactly with the account balances.
+         *
+         * @param options Shape of the book.
+         * @param sink Called with each account and its history, oldest transaction first.
+         * @return Money moved by all generated transactions.
+         */
+        template <typename Sink>
+        GeneratedTotals generateAccounts(const DatasetOptions& options, Sink sink) {
+            std::mt19937_64 random(options.seed);
+            std::uniform_int_distribution<std::size_t> pickFirstName(0, sizeof(firstNames) / sizeof(firstNames[0]) - 1);
+
+            std::vector<double> nameWeights(std::max<std::size_t>(options.lastNames, 1));
+            for (std::size_t i = 0; i < nameWeights.size(); ++i) {
+                nameWeights[i] = 1.0 / std::pow(static_cast<double>(i + 1), options.lastNameSkew);
+            }
+            std::discrete_distribution<std::size_t> pickLastName(nameWeights.begin(), nameWeights.end());
+
+            std::geometric_distribution<int> pickHistoryLength(1.0 / (std::max(options.meanHistory, 0.0) + 1.0));
+            std::uniform_int_distribution<int> pickGap(60, 2 * 24 * 60 * 60);
+            std::bernoulli_distribution pickWithdrawal(0.4);
+
+            // Histories end about now and reach back as far as a full log of two-day gaps
+            std::int64_t historyStart = static_cast<std::int64_t>(std::time(nullptr))
+                - static_cast<std::int64_t>(Account::maxTransactions) * 24 * 60 * 60;
+
+            GeneratedTotals totals;
+            Account::History history;
+
+            for (std::size_t i = 0; i < options.accounts; ++i) {
+                Account account;
+                account.setHolderFirstName(firstNames[pickFirstName(random)]);
+                account.setHolderLastName(makeLastName(pickLastName(random)));
+                account.setHolderAccountNumber(firstAccountNumber + static_cast<unsigned>(i));
+                account.setHolderPassword("Gen#" + std::to_string(random() % 1'000'000) + "pw");
+
+                int length = std::min(pickHistoryLength(random), Account::maxTransactions);
+                history.clear();
+                history.reserve(static_cast<std::size_t>(length));
+
+                std::int64_t balanceCents = 0;
+                std::int64_t when = historyStart;
+                for (int t = 0; t < length; ++t) {
+                    std::int64_t cents = drawCents(random);
+                    bool withdrawal = pickWithdrawal(random) && cents <= balanceCents;
+
+                    Account::Transaction transaction;
+                    when += pickGap(random);
+                    transaction.timestamp = when;
+                    transaction.amount = cents / 100.0;
+                    if (withdrawal) {
+                        balanceCents -= cents;
+                        totals.withdrawnCents += cents;
+                        totals.volume.recordWithdrawal(cents, when);
+                        transaction.type = Account::TransactionType::Withdrawal;
+                    }
+                    else {
+                        balanceCents += cents;
+                        totals.depositedCents += cents;
+                        totals.volume.recordDeposit(cents, when);
+                        transaction.type = Account::TransactionType::Deposit;
+                    }
+                    transaction.resultingBalance = balanceCents / 100.0;
+                    history.push_back(transaction);
+                }
+                totals.transactions += history.size();
+
+                account.setBalance(balanceCents / 100.0);
+                sink(account, history);
+            }
+
+            return totals;
+        }
+    }
+
+    /**
+     * @brief Writes a synthetic accounts.dat and funds.dat.
+     *
+     * The current layout is streamed through AccountFileWriter. The version 1 layout
+     * goes through Account::serialize, which formats every timestamp as text and is
+     * therefore much slower for large books.
+     *
+     * @param options Shape of the book.
+     * @return False if a file could not be written.
+     */
+    bool generateDataset(const DatasetOptions& options) {
+        auto start = std::chrono::steady_clock::now();
+
+        std::error_code error;
+        std::filesystem::path directory(options.directory);
+        if (!options.directory.empty()) {
+            std::filesystem::create_directories(directory, error);
+        }
+        std::filesystem::remove(directory / "journal.dat", error);
+        std::filesystem::remove(directory / "journal.dat.sealed", error);
+        std::string accountsPath = (directory / "accounts.dat").string();
+        unsigned lastAccountNumber = firstAccountNumber + static_cast<unsigned>(options.accounts);
+
+        GeneratedTotals totals;
+        bool written;
+        if (options.legacyFormat) {
+            std::ofstream out(accountsPath, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                std::cerr << "Error opening " << accountsPath << " for writing." << std::endl;
+                return false;
+            }
+
+            std::size_t count = options.accounts;
+            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            totals = generateAccounts(options, [&out](Account& account, Account::History& history) {
+                account.restoreHistory(std::move(history));
+                account.serialize(out);
+                history = Account::History();
+            });
+
+            std::uint64_t sequence = 0;
+            out.write(reinterpret_cast<const char*>(&lastAccountNumber), sizeof(lastAccountNumber));
+            out.write(reinterpret_cast<const char*>(&sequence), sizeof(sequence));
+            out.close();
+            written = !out.fail();
+        }
+        else {
+            AccountFileWriter writer(accountsPath, options.accounts, 0, lastAccountNumber);
+            if (!writer.isOpen()) {
+                std::cerr << "Error opening " << accountsPath << " for writing." << std::endl;
+                return false;
+            }
+
+            totals = generateAccounts(options, [&writer](Account& account, Account::History& history) {
+                writer.add(account, history);
+            });
+            written = writer.finish();
+        }
+
+        if (!written) {
+            std::cerr << "Error writing " << accountsPath << "." << std::endl;
+            return false;
+        }
+
+        // funds.dat goes through the normal save path so its layout always matches
+        Storage storage(options.directory);
+        BankFunds bank;
+        bank.setTotalDeposits(totals.depositedCents / 100.0);
+        bank.setTotalWithdrawals(totals.withdrawnCents / 100.0);
+        bank.setTotalHoldings(bank.getTotalHoldings() + (totals.depositedCents - totals.withdrawnCents) / 100.0);
+        bank.getVolume() = totals.volume;
+        storage.getFunds().push_back(bank);
+        storage.saveBank();
+
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "Generated " << options.accounts << " accounts with " << totals.transactions
+            << " transactions in " << seconds << " s (" << (options.legacyFormat ? "version 1" : "current")
+            << " layout)." << std::endl;
+        return true;
+    }
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace bankSimulation {
+
+	/**
+	 * @struct DatasetOptions
+	 * @brief Shape of a generated book of accounts.
+	 */
+	struct DatasetOptions {
+		std::size_t accounts = 100'000;     ///< Number of accounts to create
+		unsigned seed = 1;                  ///< Random seed; equal options give identical files
+		std::size_t lastNames = 10'000;     ///< Distinct last names to draw from
+		double lastNameSkew = 1.0;          ///< Zipf exponent of the last name draw; 0 is uniform
+		double meanHistory = 20.0;          ///< Mean transactions per account, capped at Account::maxTransactions
+		bool legacyFormat = false;          ///< Write version 1 through Account::serialize instead of the current layout
+		std::string directory;              ///< Directory for the data files; empty for the working directory
+	};
+
+	/**
+	 * @brief Writes a synthetic accounts.dat and funds.dat.
+	 *
+	 * Accounts are numbered from 10,000 like those created through Storage::newAccount
+	 * and open with a zero balance. Last names follow a Zipf distribution, so popular
+	 * names are shared by many accounts. History lengths follow a geometric distribution.
+	 * Every transaction is valid: amounts stay within the allowed range and balances
+	 * never go negative. The bank totals in funds.dat match the generated transactions.
+	 *
+	 * Accounts are streamed to disk one at a time, so memory use does not grow with the
+	 * account count. Any journal.dat in the directory is removed, since its records
+	 * would not belong to the new book.
+	 *
+	 * @param options Shape of the book.
+	 * @return False if a file could not be written.
+	 */
+	bool generateDataset(const DatasetOptions& options);
+}
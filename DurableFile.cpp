@@ -0,0 +1,253 @@
+#include "DurableFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace bankSimulation {
+
+    /**
+     * @brief Closes the file if it is still open.
+     */
+    DurableFile::~DurableFile() {
+        close();
+    }
+
+    /**
+     * @brief Opens a file for appending, creating it if missing.
+     *
+     * Any previously open file is closed first. Every write lands at the current end of
+     * the file, even if another handle has extended it.
+     *
+     * @param path File to open.
+     * @return True if the file is open.
+     */
+    bool DurableFile::openForAppend(const std::string& path) {
+        close();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        handle = file;
+#else
+        descriptor = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (descriptor < 0) {
+            descriptor = -1;
+            return false;
+        }
+#endif
+        return true;
+    }
+
+    /**
+     * @brief Opens an existing file for reading and writing at explicit offsets.
+     *
+     * Any previously open file is closed first.
+     *
+     * @param path File to open.
+     * @return True if the file is open.
+     */
+    bool DurableFile::openForUpdate(const std::string& path) {
+        close();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        handle = file;
+#else
+        descriptor = ::open(path.c_str(), O_RDWR);
+        if (descriptor < 0) {
+            descriptor = -1;
+            return false;
+        }
+#endif
+        return true;
+    }
+
+    /**
+     * @brief Closes the file.
+     */
+    void DurableFile::close() {
+#ifdef _WIN32
+        if (handle) {
+            CloseHandle(static_cast<HANDLE>(handle));
+            handle = nullptr;
+        }
+#else
+        if (descriptor >= 0) {
+            ::close(descriptor);
+            descriptor = -1;
+        }
+#endif
+    }
+
+    /**
+     * @brief Checks whether a file is open.
+     * @return True if open.
+     */
+    bool DurableFile::isOpen() const {
+#ifdef _WIN32
+        return handle != nullptr;
+#else
+        return descriptor >= 0;
+#endif
+    }
+
+    /**
+     * @brief Appends bytes, retrying short writes until all are written.
+     *
+     * @param data Bytes to write.
+     * @param size Number of bytes.
+     * @return True if every byte was written.
+     */
+    bool DurableFile::write(const void* data, std::size_t size) {
+        const char* next = static_cast<const char*>(data);
+        while (size > 0) {
+#ifdef _WIN32
+            DWORD written = 0;
+            DWORD chunk = size > 0x40000000 ? 0x40000000 : static_cast<DWORD>(size);
+            if (!WriteFile(static_cast<HANDLE>(handle), next, chunk, &written, nullptr)) {
+                return false;
+            }
+#else
+            ssize_t written = ::write(descriptor, next, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+#endif
+            next += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes bytes at an offset without moving any file position.
+     *
+     * @param offset File offset of the first byte.
+     * @param data Bytes to write.
+     * @param size Number of bytes.
+     * @return True if every byte was written.
+     */
+    bool DurableFile::writeAt(std::uint64_t offset, const void* data, std::size_t size) {
+        const char* next = static_cast<const char*>(data);
+        while (size > 0) {
+#ifdef _WIN32
+            OVERLAPPED position = {};
+            position.Offset = static_cast<DWORD>(offset);
+            position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD written = 0;
+            DWORD chunk = size > 0x40000000 ? 0x40000000 : static_cast<DWORD>(size);
+            if (!WriteFile(static_cast<HANDLE>(handle), next, chunk, &written, &position)) {
+                return false;
+            }
+#else
+            ssize_t written = ::pwrite(descriptor, next, size, static_cast<off_t>(offset));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+#endif
+            next += written;
+            offset += static_cast<std::uint64_t>(written);
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads bytes at an offset without moving any file position.
+     *
+     * @param offset File offset of the first byte.
+     * @param data Buffer to fill.
+     * @param size Number of bytes.
+     * @return True if every byte was read.
+     */
+    bool DurableFile::readAt(std::uint64_t offset, void* data, std::size_t size) {
+        char* next = static_cast<char*>(data);
+        while (size > 0) {
+#ifdef _WIN32
+            OVERLAPPED position = {};
+            position.Offset = static_cast<DWORD>(offset);
+            position.OffsetHigh = static_cast<DWORD>(offset >> 32);
+            DWORD read = 0;
+            DWORD chunk = size > 0x40000000 ? 0x40000000 : static_cast<DWORD>(size);
+            if (!ReadFile(static_cast<HANDLE>(handle), next, chunk, &read, &position) || read == 0) {
+                return false;
+            }
+#else
+            ssize_t read = ::pread(descriptor, next, size, static_cast<off_t>(offset));
+            if (read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (read <= 0) {
+                return false;
+            }
+#endif
+            next += read;
+            offset += static_cast<std::uint64_t>(read);
+            size -= static_cast<std::size_t>(read);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Forces written data to stable storage.
+     *
+     * Uses fdatasync where available, since only the data and the file length matter,
+     * not timestamps.
+     *
+     * @return True on success.
+     */
+    bool DurableFile::sync() {
+#ifdef _WIN32
+        return FlushFileBuffers(static_cast<HANDLE>(handle)) != 0;
+#elif defined(__APPLE__)
+        return ::fcntl(descriptor, F_FULLFSYNC) == 0 || ::fsync(descriptor) == 0;
+#elif defined(_POSIX_SYNCHRONIZED_IO) && _POSIX_SYNCHRONIZED_IO > 0
+        return ::fdatasync(descriptor) == 0;
+#else
+        return ::fsync(descriptor) == 0;
+#endif
+    }
+
+    /**
+     * @brief Syncs the directory holding a file, so a rename into it survives a crash.
+     * @param file Path of a file in the directory.
+     * @return True on success.
+     */
+    bool syncDirectoryOf(const std::string& file) {
+#ifdef _WIN32
+        (void)file;
+        return true;
+#else
+        std::string::size_type slash = file.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : file.substr(0, slash));
+
+        int descriptor = ::open(directory.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return false;
+        }
+        bool synced = ::fsync(descriptor) == 0;
+        ::close(descriptor);
+        return synced;
+#endif
+    }
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bankSimulation {
+
+	/**
+	 * @class DurableFile
+	 * @brief An unbuffered file that can be forced to stable storage.
+	 *
+	 * Wraps a POSIX descriptor or a Windows handle. Writes go straight to the operating
+	 * system, and sync() waits until the device has them (fsync / FlushFileBuffers),
+	 * which std::ofstream cannot do. Callers batch their bytes before writing, so the
+	 * missing user-space buffer costs nothing.
+	 *
+	 * A file opened for appending is written at its end; one opened for update is read
+	 * and written at explicit offsets (pread/pwrite), leaving everything else in place.
+	 */
+	class DurableFile {
+	private:
+#ifdef _WIN32
+		void* handle = nullptr;       ///< Handle of the open file
+#else
+		int descriptor = -1;          ///< Descriptor of the open file
+#endif
+
+	public:
+		DurableFile() = default;
+		DurableFile(const DurableFile&) = delete;
+		DurableFile& operator=(const DurableFile&) = delete;
+
+		/**
+		 * @brief Closes the file if it is still open.
+		 */
+		~DurableFile();
+
+		/**
+		 * @brief Opens a file for appending, creating it if missing.
+		 *
+		 * @param path File to open.
+		 * @return True if the file is open.
+		 */
+		bool openForAppend(const std::string& path);
+
+		/**
+		 * @brief Opens an existing file for reading and writing at explicit offsets.
+		 *
+		 * @param path File to open.
+		 * @return True if the file is open.
+		 */
+		bool openForUpdate(const std::string& path);
+
+		/**
+		 * @brief Closes the file.
+		 */
+		void close();
+
+		/**
+		 * @brief Checks whether a file is open.
+		 * @return True if open.
+		 */
+		bool isOpen() const;
+
+		/**
+		 * @brief Appends bytes at the end of the file.
+		 *
+		 * @param data Bytes to write.
+		 * @param size Number of bytes.
+		 * @return True if every byte was written.
+		 */
+		bool write(const void* data, std::size_t size);
+
+		/**
+		 * @brief Writes bytes at an offset, growing the file if the range ends past it.
+		 *
+		 * @param offset File offset of the first byte.
+		 * @param data Bytes to write.
+		 * @param size Number of bytes.
+		 * @return True if every byte was written.
+		 */
+		bool writeAt(std::uint64_t offset, const void* data, std::size_t size);
+
+		/**
+		 * @brief Reads bytes at an offset of a file opened for update.
+		 *
+		 * @param offset File offset of the first byte.
+		 * @param data Buffer to fill.
+		 * @param size Number of bytes.
+		 * @return True if every byte was read; false at the end of the file.
+		 */
+		bool readAt(std::uint64_t offset, void* data, std::size_t size);
+
+		/**
+		 * @brief Waits until everything written so far is on stable storage.
+		 * @return True on success.
+		 */
+		bool sync();
+	};
+
+	/**
+	 * @brief Makes a rename or newly created file in a directory durable.
+	 *
+	 * Syncs the directory entry on POSIX systems; a no-op on Windows, where replaceFile
+	 * already moves with write-through.
+	 *
+	 * @param file Path of a file in the directory.
+	 * @return True on success.
+	 */
+	bool syncDirectoryOf(const std::string& file);
+}
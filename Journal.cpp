@@ -0,0 +1,349 @@
+#include "Journal.h"
+#include "MappedFile.h"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace bankSimulation {
+
+    /**
+     * @brief Creates a journal backed by the given file.
+     *
+     * The file itself is not opened until the first append.
+     *
+     * @param path Journal file location.
+     */
+    Journal::Journal(const std::string& path) : path(path), sealedPath(path + ".sealed") {}
+
+    /**
+     * @brief Writes a record field by field in binary format.
+     *
+     * @param out Output stream to write to.
+     * @param record Record to write.
+     */
+    void Journal::writeRecord(std::ostream& out, const Record& record) {
+        out.write(reinterpret_cast<const char*>(&record.sequence), sizeof(record.sequence));
+        out.write(reinterpret_cast<const char*>(&record.accountNumber), sizeof(record.accountNumber));
+        out.write(&record.type, sizeof(record.type));
+        out.write(reinterpret_cast<const char*>(&record.amount), sizeof(record.amount));
+        out.write(reinterpret_cast<const char*>(&record.resultingBalance), sizeof(record.resultingBalance));
+        out.write(reinterpret_cast<const char*>(&record.timestamp), sizeof(record.timestamp));
+    }
+
+    /**
+     * @brief Encodes a record field by field, in the same layout as writeRecord().
+     *
+     * @param buffer Buffer to append the encoded record to.
+     * @param record Record to encode.
+     */
+    void Journal::encodeRecord(std::vector<char>& buffer, const Record& record) {
+        std::size_t offset = buffer.size();
+        buffer.resize(offset + recordSize);
+        char* next = buffer.data() + offset;
+
+        auto put = [&next](const void* field, std::size_t size) {
+            std::memcpy(next, field, size);
+            next += size;
+        };
+        put(&record.sequence, sizeof(record.sequence));
+        put(&record.accountNumber, sizeof(record.accountNumber));
+        put(&record.type, sizeof(record.type));
+        put(&record.amount, sizeof(record.amount));
+        put(&record.resultingBalance, sizeof(record.resultingBalance));
+        put(&record.timestamp, sizeof(record.timestamp));
+    }
+
+    /**
+     * @brief Reads a record field by field in binary format.
+     *
+     * @param in Input stream to read from.
+     * @param record Record to fill in.
+     * @return True if a complete record was read.
+     */
+    bool Journal::readRecord(std::istream& in, Record& record) {
+        in.read(reinterpret_cast<char*>(&record.sequence), sizeof(record.sequence));
+        in.read(reinterpret_cast<char*>(&record.accountNumber), sizeof(record.accountNumber));
+        in.read(&record.type, sizeof(record.type));
+        in.read(reinterpret_cast<char*>(&record.amount), sizeof(record.amount));
+        in.read(reinterpret_cast<char*>(&record.resultingBalance), sizeof(record.resultingBalance));
+        in.read(reinterpret_cast<char*>(&record.timestamp), sizeof(record.timestamp));
+        return static_cast<bool>(in);
+    }
+
+    /**
+     * @brief Reads one journal file and repairs a torn tail.
+     *
+     * @param file File to read.
+     * @return Every complete record, in append order; none if the file is missing.
+     */
+    std::vector<Journal::Record> Journal::readFile(const std::string& file) {
+        std::vector<Record> complete;
+        std::ifstream in(file, std::ios::binary);
+
+        if (!in) {
+            return complete;
+        }
+
+        in.seekg(0, std::ios::end);
+        std::streamoff fileSize = in.tellg();
+        in.seekg(0, std::ios::beg);
+
+        Record record;
+        while (readRecord(in, record)) {
+            complete.push_back(record);
+        }
+
+        // A partial record left by a crash mid-append would misalign every later
+        // append, so rewrite the file with only the complete records.
+        bool torn = fileSize != static_cast<std::streamoff>(complete.size() * recordSize);
+        in.close();
+        if (torn) {
+            std::ofstream rewrite(file, std::ios::binary | std::ios::trunc);
+            for (const auto& r : complete) {
+                writeRecord(rewrite, r);
+            }
+        }
+        return complete;
+    }
+
+    /**
+     * @brief Reads the journal tail that follows a checkpoint.
+     *
+     * Reads the sealed records, then the current file, skips every record already
+     * covered by the checkpoint or seen before, and collects the rest. Each file stops
+     * at its first incomplete record.
+     *
+     * @param afterSequence Sequence number already covered by a checkpoint.
+     * @return Records newer than the checkpoint, in append order.
+     */
+    std::vector<Journal::Record> Journal::readAfter(std::uint64_t afterSequence) {
+        std::vector<Record> tail;
+        std::size_t count = 0;
+        std::uint64_t taken = afterSequence;
+
+        for (const std::string* file : { &sealedPath, &path }) {
+            std::vector<Record> complete = readFile(*file);
+            for (const auto& r : complete) {
+                if (r.sequence > lastSequence) {
+                    lastSequence = r.sequence;
+                }
+                // A crash while sealing can leave the same records in both files
+                if (r.sequence > taken) {
+                    tail.push_back(r);
+                    taken = r.sequence;
+                }
+            }
+            count += complete.size();
+        }
+        recordCount = count;
+
+        return tail;
+    }
+
+    /**
+     * @brief Opens the journal for appending on first use.
+     * @return True if the journal is open.
+     */
+    bool Journal::openForAppend() {
+        if (!out.isOpen() && !out.openForAppend(path)) {
+            std::cerr << "Error opening " << path << " for writing." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes the encoded records in one call and syncs them.
+     *
+     * A record is only durable once the sync returns; until then it may still be lost
+     * with the operating system's cache. If the write or the sync fails, whatever part
+     * of the buffer reached the file is cut off again, so later appends stay aligned to
+     * whole records and never follow records whose sequence numbers are reused.
+     *
+     * @return True if the records reached stable storage.
+     */
+    bool Journal::writeEncoded() {
+        std::error_code error;
+        std::uintmax_t before = std::filesystem::file_size(path, error);
+
+        bool durable = out.write(encoded.data(), encoded.size()) && out.sync();
+        if (!durable) {
+            std::cerr << "Error writing " << path << "." << std::endl;
+            out.close();
+            if (!error) {
+                std::filesystem::resize_file(path, before, error);
+            }
+        }
+        encoded.clear();
+        return durable;
+    }
+
+    /**
+     * @brief Appends a single record to the end of the journal.
+     *
+     * Assigns the next sequence number, writes the record, and syncs it so that it
+     * is on stable storage before the transaction is reported as done. The sequence
+     * number is only used up once the record is durable.
+     *
+     * @param record Record to append.
+     * @return Sequence number assigned to the record, or 0 if it is not durable.
+     */
+    std::uint64_t Journal::append(Record& record) {
+        record.sequence = 0;
+        if (!openForAppend()) {
+            return 0;
+        }
+
+        record.sequence = lastSequence + 1;
+        encodeRecord(encoded, record);
+        if (!writeEncoded()) {
+            record.sequence = 0;
+            return 0;
+        }
+        lastSequence = record.sequence;
+        ++recordCount;
+
+        return record.sequence;
+    }
+
+    /**
+     * @brief Appends a batch of records with a single write and a single sync.
+     *
+     * Used by the PersistenceWorker for group commit: every record in the batch
+     * becomes durable with the same fsync, so its cost is shared by the batch.
+     *
+     * @param records Records to append, in order.
+     * @return Sequence number of the last record, or 0 if the batch is not durable.
+     */
+    std::uint64_t Journal::appendBatch(std::vector<Record>& records) {
+        if (records.empty()) {
+            return lastSequence;
+        }
+
+        std::uint64_t sequence = lastSequence;
+        if (openForAppend()) {
+            encoded.reserve(records.size() * recordSize);
+            for (auto& record : records) {
+                record.sequence = ++sequence;
+                encodeRecord(encoded, record);
+            }
+            if (writeEncoded()) {
+                lastSequence = sequence;
+                recordCount += records.size();
+                return lastSequence;
+            }
+        }
+
+        for (auto& record : records) {
+            record.sequence = 0;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Empties the journal file and deletes the sealed records.
+     *
+     * Only called once accounts.dat and funds.dat both hold every journaled record.
+     * The sequence counter keeps counting so later records stay ordered after the
+     * checkpoint.
+     *
+     * @return Bytes the two files held.
+     */
+    std::uint64_t Journal::truncate() {
+        out.close();
+
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(path, error);
+        std::uint64_t freed = error ? 0 : static_cast<std::uint64_t>(size);
+
+        std::ofstream reset(path, std::ios::binary | std::ios::trunc);
+        if (!reset) {
+            std::cerr << "Error truncating " << path << "." << std::endl;
+            return 0;
+        }
+
+        recordCount = 0;
+        return freed + discardSealed();
+    }
+
+    /**
+     * @brief Renames the journal to the sealed file, so the next append creates a new one.
+     *
+     * The rename and the directory entry are synced before returning: a transaction
+     * appended to the new file right afterwards must not outlive a crash that loses it.
+     * If a failed checkpoint left sealed records behind, the current ones are appended to
+     * them and the journal is emptied, keeping both in sequence order.
+     *
+     * @return True if every record written so far is in the sealed file.
+     */
+    bool Journal::seal() {
+        out.close();
+
+        std::error_code error;
+        if (!std::filesystem::exists(path, error)) {
+            recordCount = 0;
+            return true;
+        }
+
+        if (std::filesystem::exists(sealedPath, error)) {
+            std::vector<Record> current = readFile(path);
+            DurableFile sealed;
+            for (const auto& record : current) {
+                encodeRecord(encoded, record);
+            }
+            bool moved = sealed.openForAppend(sealedPath) && sealed.write(encoded.data(), encoded.size()) && sealed.sync();
+            encoded.clear();
+            if (!moved) {
+                std::cerr << "Error sealing " << path << "." << std::endl;
+                return false;
+            }
+            std::ofstream reset(path, std::ios::binary | std::ios::trunc);
+        }
+        else if (!replaceFile(path, sealedPath) || !syncDirectoryOf(path)) {
+            std::cerr << "Error sealing " << path << "." << std::endl;
+            return false;
+        }
+
+        recordCount = 0;
+        return true;
+    }
+
+    /**
+     * @brief Deletes the sealed file.
+     * @return Bytes it held, or 0 if there was none.
+     */
+    std::uint64_t Journal::discardSealed() {
+        std::error_code error;
+        std::uintmax_t size = std::filesystem::file_size(sealedPath, error);
+        if (error || !std::filesystem::remove(sealedPath, error)) {
+            return 0;
+        }
+        return static_cast<std::uint64_t>(size);
+    }
+
+    /**
+     * @brief Moves the sequence counter forward to at least the given value.
+     * @param sequence Sequence number recorded by a checkpoint.
+     */
+    void Journal::advanceTo(std::uint64_t sequence) {
+        if (sequence > lastSequence) {
+            lastSequence = sequence;
+        }
+    }
+
+    /**
+     * @brief Gets the highest sequence number handed out so far.
+     * @return Last sequence number.
+     */
+    std::uint64_t Journal::getLastSequence() const {
+        return lastSequence;
+    }
+
+    /**
+     * @brief Gets the number of records appended since the last truncation or seal.
+     * @return Record count.
+     */
+    std::size_t Journal::getRecordCount() const {
+        return recordCount;
+    }
+}
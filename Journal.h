@@ -0,0 +1,183 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "DurableFile.h"
+
+namespace bankSimulation {
+
+	/**
+	 * @class Journal
+	 * @brief Append-only write-ahead log of account transactions ("journal.dat").
+	 *
+	 * Every deposit or withdrawal appends one fixed-size record instead of rewriting
+	 * accounts.dat and funds.dat. Those files become periodic checkpoints that remember
+	 * the sequence number of the last record they include, so that on startup only the
+	 * journal tail written after the checkpoint needs to be replayed.
+	 *
+	 * Appends come from one thread at a time: the teller in Sync mode, otherwise the
+	 * PersistenceWorker. Only the record count may be read from other threads meanwhile.
+	 * An append returns only once its records are on stable storage, so the cost of a
+	 * write is dominated by the fsync; appendBatch() shares one fsync across a batch.
+	 *
+	 * A background checkpoint seals the journal when it captures the state: the records
+	 * so far move to a second file ("journal.dat.sealed") and new appends start an empty
+	 * one, so the checkpoint can be written while transactions keep going. The sealed
+	 * file is deleted once the checkpoint is durable; until then both files are replayed.
+	 */
+	class Journal {
+	public:
+		/**
+		 * @struct Record
+		 * @brief One journaled transaction.
+		 */
+		struct Record {
+			std::uint64_t sequence;        ///< Monotonic sequence number of the record
+			unsigned accountNumber;        ///< Account the transaction was applied to
+			char type;                     ///< 'D' for deposit, 'W' for withdrawal
+			double amount;                 ///< Amount of the transaction
+			double resultingBalance;       ///< Account balance after the transaction
+			std::int64_t timestamp;        ///< Seconds since the epoch
+		};
+
+	private:
+		/// Size of one record on disk
+		static const std::size_t recordSize = sizeof(std::uint64_t) + sizeof(unsigned) + sizeof(char)
+			+ 2 * sizeof(double) + sizeof(std::int64_t);
+
+		std::string path;                  ///< Location of the journal file
+		std::string sealedPath;            ///< Location of the sealed records awaiting a checkpoint
+		DurableFile out;                   ///< Append handle, opened on first use
+		std::vector<char> encoded;         ///< Reused buffer the records of one write are encoded into
+		std::uint64_t lastSequence = 0;    ///< Highest sequence number handed out so far
+		std::atomic<std::size_t> recordCount{ 0 };  ///< Records written since the last truncation or seal
+
+		/**
+		 * @brief Writes a record in its fixed on-disk layout.
+		 */
+		static void writeRecord(std::ostream& out, const Record& record);
+
+		/**
+		 * @brief Adds a record in its fixed on-disk layout to the end of a buffer.
+		 */
+		static void encodeRecord(std::vector<char>& buffer, const Record& record);
+
+		/**
+		 * @brief Opens the append handle if it is not open yet.
+		 * @return False if the file could not be opened.
+		 */
+		bool openForAppend();
+
+		/**
+		 * @brief Writes the encoded buffer and waits until it is on stable storage.
+		 *
+		 * On failure cuts the file back to its length before the write.
+		 *
+		 * @return False if the write or the sync failed.
+		 */
+		bool writeEncoded();
+
+		/**
+		 * @brief Reads a record in its fixed on-disk layout.
+		 * @return False if the stream ended before a complete record was read.
+		 */
+		static bool readRecord(std::istream& in, Record& record);
+
+		/**
+		 * @brief Reads every complete record of one journal file, dropping a torn tail.
+		 * @param file File to read; missing files hold no records.
+		 * @return Records in the order they were appended.
+		 */
+		static std::vector<Record> readFile(const std::string& file);
+
+	public:
+		/**
+		 * @brief Creates a journal backed by the given file.
+		 * @param path Journal file location.
+		 */
+		explicit Journal(const std::string& path = "journal.dat");
+
+		/**
+		 * @brief Reads every complete record with a sequence number above the given one.
+		 *
+		 * Reads the sealed file first, if a checkpoint did not get to delete it. Also
+		 * advances the sequence counter past every record found on disk, so that new
+		 * appends never reuse a sequence number. A torn record at the end of a file
+		 * (from a crash mid-append) is ignored.
+		 *
+		 * @param afterSequence Sequence number already covered by a checkpoint.
+		 * @return Records in the order they were appended.
+		 */
+		std::vector<Record> readAfter(std::uint64_t afterSequence);
+
+		/**
+		 * @brief Appends a record and syncs it to stable storage.
+		 *
+		 * Assigns the next sequence number to the record. If the record cannot be written
+		 * and synced, the sequence number is not used up and the record is not counted.
+		 *
+		 * @param record Record to append; its sequence field is overwritten, with 0 on failure.
+		 * @return The sequence number assigned, or 0 if the record is not durable.
+		 */
+		std::uint64_t append(Record& record);
+
+		/**
+		 * @brief Appends several records and syncs them together.
+		 *
+		 * Assigns consecutive sequence numbers in order, so the result is the same as
+		 * appending each record in turn, with one write and one fsync instead of one each.
+		 * The batch succeeds or fails as a whole: on failure no sequence number is used up
+		 * and no record is counted.
+		 *
+		 * @param records Records to append; their sequence fields are overwritten, with 0 on failure.
+		 * @return The last sequence number assigned, or 0 if the records are not durable.
+		 */
+		std::uint64_t appendBatch(std::vector<Record>& records);
+
+		/**
+		 * @brief Discards every record once a checkpoint has made them redundant.
+		 *
+		 * Empties the journal and deletes the sealed file.
+		 *
+		 * @return Bytes freed.
+		 */
+		std::uint64_t truncate();
+
+		/**
+		 * @brief Moves every record written so far aside, so later appends start a new file.
+		 *
+		 * Must not run concurrently with an append. The sealed records stay on disk, and
+		 * are replayed after a crash, until discardSealed(). If a sealed file is left
+		 * from a checkpoint that failed, the current records are added to it instead.
+		 *
+		 * @return False if the records could not be moved; they then stay in the journal.
+		 */
+		bool seal();
+
+		/**
+		 * @brief Deletes the sealed records once a checkpoint includes all of them.
+		 * @return Bytes freed.
+		 */
+		std::uint64_t discardSealed();
+
+		/**
+		 * @brief Ensures the sequence counter is at least the given value.
+		 * @param sequence Sequence number recorded by a checkpoint.
+		 */
+		void advanceTo(std::uint64_t sequence);
+
+		/**
+		 * @brief Gets the highest sequence number handed out so far.
+		 * @return Last sequence number.
+		 */
+		std::uint64_t getLastSequence() const;
+
+		/**
+		 * @brief Gets the number of records appended since the last truncation or seal.
+		 * @return Record count.
+		 */
+		std::size_t getRecordCount() const;
+	};
+}
@@ -0,0 +1,155 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace bankSimulation {
+
+    /**
+     * @brief Unmaps the file if it is still mapped.
+     */
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    /**
+     * @brief Maps an entire file into memory for reading.
+     *
+     * Any previous mapping is released first. Empty files cannot be mapped and are
+     * reported as failures so callers can fall back to their default handling.
+     *
+     * @param path File to map.
+     * @return True if the file was mapped.
+     */
+    bool MappedFile::open(const std::string& path) {
+        close();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) {
+            CloseHandle(file);
+            return false;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (!view) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+
+        fileHandle = file;
+        mappingHandle = mapping;
+        data = static_cast<const char*>(view);
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* view = mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED) {
+            ::close(fd);
+            return false;
+        }
+
+        descriptor = fd;
+        data = static_cast<const char*>(view);
+        size = static_cast<std::size_t>(info.st_size);
+#endif
+        return true;
+    }
+
+    /**
+     * @brief Releases the mapping and the underlying file.
+     */
+    void MappedFile::close() {
+        if (!data) {
+            return;
+        }
+
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+        CloseHandle(static_cast<HANDLE>(fileHandle));
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+#else
+        munmap(const_cast<char*>(data), size);
+        ::close(descriptor);
+        descriptor = -1;
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    /**
+     * @brief Checks whether a file is currently mapped.
+     * @return True if mapped.
+     */
+    bool MappedFile::isOpen() const {
+        return data != nullptr;
+    }
+
+    /**
+     * @brief Gets the start of the mapped bytes.
+     * @return Pointer to the first byte, or nullptr if nothing is mapped.
+     */
+    const char* MappedFile::getData() const {
+        return data;
+    }
+
+    /**
+     * @brief Gets the number of mapped bytes.
+     * @return Size of the file in bytes.
+     */
+    std::size_t MappedFile::getSize() const {
+        return size;
+    }
+
+    /**
+     * @brief Moves a file over another one, replacing it in a single step.
+     *
+     * Uses MoveFileEx on Windows, where rename refuses to overwrite, and rename elsewhere.
+     * On Windows the move is written through; elsewhere follow it with syncDirectoryOf.
+     *
+     * @param source File to move.
+     * @param target File to replace.
+     * @return True on success.
+     */
+    bool replaceFile(const std::string& source, const std::string& target) {
+#ifdef _WIN32
+        return MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return std::rename(source.c_str(), target.c_str()) == 0;
+#endif
+    }
+}
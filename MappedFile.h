@@ -0,0 +1,78 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace bankSimulation {
+
+	/**
+	 * @class MappedFile
+	 * @brief Read-only memory mapping of a whole file.
+	 *
+	 * Wraps mmap on POSIX systems and CreateFileMapping/MapViewOfFile on Windows so that
+	 * loaders can read a data file in place instead of streaming it field by field.
+	 * The mapping is released when the object is closed or destroyed.
+	 */
+	class MappedFile {
+	private:
+		const char* data = nullptr;   ///< Start of the mapped view
+		std::size_t size = 0;         ///< Length of the mapped view in bytes
+#ifdef _WIN32
+		void* fileHandle = nullptr;   ///< Handle of the open file
+		void* mappingHandle = nullptr;///< Handle of the file mapping object
+#else
+		int descriptor = -1;          ///< Descriptor of the open file
+#endif
+
+	public:
+		MappedFile() = default;
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/**
+		 * @brief Unmaps the file if it is still mapped.
+		 */
+		~MappedFile();
+
+		/**
+		 * @brief Maps an entire file into memory for reading.
+		 *
+		 * @param path File to map.
+		 * @return True if the file exists, is not empty, and was mapped.
+		 */
+		bool open(const std::string& path);
+
+		/**
+		 * @brief Releases the mapping and the underlying file.
+		 */
+		void close();
+
+		/**
+		 * @brief Checks whether a file is currently mapped.
+		 * @return True if mapped.
+		 */
+		bool isOpen() const;
+
+		/**
+		 * @brief Gets the start of the mapped bytes.
+		 * @return Pointer to the first byte, or nullptr if nothing is mapped.
+		 */
+		const char* getData() const;
+
+		/**
+		 * @brief Gets the number of mapped bytes.
+		 * @return Size of the file in bytes.
+		 */
+		std::size_t getSize() const;
+	};
+
+	/**
+	 * @brief Moves a file over another one, replacing it in a single step.
+	 *
+	 * Any mapping of the target must be closed first.
+	 *
+	 * @param source File to move.
+	 * @param target File to replace.
+	 * @return True if the target now holds the contents of the source.
+	 */
+	bool replaceFile(const std::string& source, const std::string& target);
+}
@@ -0,0 +1,267 @@
+#include "Metrics.h"
+#include <fstream>
+#include <iomanip>
+
+namespace bankSimulation {
+
+    /**
+     * @brief Creates an empty histogram.
+     */
+    LatencyHistogram::LatencyHistogram() {
+        for (auto& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Finds the bucket holding a value.
+     *
+     * Values below 2^subBucketBits map to themselves. Larger values keep their leading
+     * subBucketBits + 1 bits: the position of the top bit selects the power of two, and
+     * the following bits select the sub-bucket within it.
+     *
+     * @param value Value to place.
+     * @return Bucket index.
+     */
+    std::size_t LatencyHistogram::bucketFor(std::uint64_t value) {
+        const std::uint64_t subBuckets = std::uint64_t(1) << subBucketBits;
+        if (value < subBuckets) {
+            return static_cast<std::size_t>(value);
+        }
+
+        int topBit = 0;
+        for (int step = 32; step > 0; step /= 2) {
+            if (value >> (topBit + step)) {
+                topBit += step;
+            }
+        }
+
+        int shift = topBit - subBucketBits;
+        std::uint64_t subBucket = (value >> shift) & (subBuckets - 1);
+        return static_cast<std::size_t>((shift + 1) * subBuckets + subBucket);
+    }
+
+    /**
+     * @brief Gets the largest value a bucket can hold.
+     * @param bucket Bucket index.
+     * @return Inclusive upper bound of the bucket.
+     */
+    std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t bucket) {
+        const std::uint64_t subBuckets = std::uint64_t(1) << subBucketBits;
+        if (bucket < subBuckets) {
+            return bucket;
+        }
+
+        int shift = static_cast<int>(bucket / subBuckets) - 1;
+        std::uint64_t lower = (subBuckets + bucket % subBuckets) << shift;
+        return lower + ((std::uint64_t(1) << shift) - 1);
+    }
+
+    /**
+     * @brief Records one latency.
+     * @param nanoseconds Measured latency.
+     */
+    void LatencyHistogram::record(std::uint64_t nanoseconds) {
+        buckets[bucketFor(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+        count.fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+        std::uint64_t seen = maximum.load(std::memory_order_relaxed);
+        while (nanoseconds > seen && !maximum.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Gets the number of recorded values.
+     * @return Count.
+     */
+    std::uint64_t LatencyHistogram::getCount() const {
+        return count.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Gets the mean of the recorded values.
+     * @return Mean in nanoseconds.
+     */
+    double LatencyHistogram::getMean() const {
+        std::uint64_t n = getCount();
+        return n == 0 ? 0.0 : static_cast<double>(total.load(std::memory_order_relaxed)) / n;
+    }
+
+    /**
+     * @brief Gets the largest recorded value.
+     * @return Maximum in nanoseconds.
+     */
+    std::uint64_t LatencyHistogram::getMax() const {
+        return maximum.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Estimates a percentile by walking the buckets in order.
+     *
+     * @param percentile Percentile between 0 and 100.
+     * @return Upper bound of the bucket holding the percentile, at most getMax().
+     */
+    std::uint64_t LatencyHistogram::getPercentile(double percentile) const {
+        std::uint64_t n = getCount();
+        if (n == 0) {
+            return 0;
+        }
+
+        std::uint64_t rank = static_cast<std::uint64_t>(percentile / 100.0 * n + 0.5);
+        rank = rank < 1 ? 1 : (rank > n ? n : rank);
+
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < bucketCount; ++b) {
+            seen += buckets[b].load(std::memory_order_relaxed);
+            if (seen >= rank) {
+                std::uint64_t bound = bucketUpperBound(b);
+                return bound < getMax() ? bound : getMax();
+            }
+        }
+        return getMax();
+    }
+
+    /**
+     * @brief Discards every recorded value.
+     */
+    void LatencyHistogram::reset() {
+        for (auto& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        count.store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        maximum.store(0, std::memory_order_relaxed);
+    }
+
+    namespace metrics {
+        std::atomic<bool> enabled{ false };
+
+        namespace {
+            const char* const metricNames[] = {
+                "deposit", "withdrawal", "log_transaction", "save_account", "save_bank", "load_account", "login_lookup",
+                "checkpoint", "checkpoint_pause"
+            };
+
+            const char* const counterNames[] = {
+                "deposits_applied", "withdrawals_applied", "insufficient_funds", "invalid_amounts",
+                "journal_records", "journal_write_failures", "checkpoints", "checkpoint_bytes_reclaimed", "history_page_ins", "history_evictions"
+            };
+
+            static_assert(sizeof(metricNames) / sizeof(metricNames[0]) == static_cast<std::size_t>(Metric::Count),
+                "every metric needs a name");
+            static_assert(sizeof(counterNames) / sizeof(counterNames[0]) == static_cast<std::size_t>(Counter::Count),
+                "every counter needs a name");
+
+            LatencyHistogram histograms[static_cast<std::size_t>(Metric::Count)];
+            std::atomic<std::uint64_t> counters[static_cast<std::size_t>(Counter::Count)] = {};
+
+            /**
+             * @brief Formats nanoseconds as microseconds for the report.
+             * @param nanoseconds Latency to format.
+             * @return Microseconds.
+             */
+            double toMicroseconds(double nanoseconds) {
+                return nanoseconds / 1'000.0;
+            }
+        }
+
+        /**
+         * @brief Turns instrumentation on or off.
+         * @param on True to start recording.
+         */
+        void setEnabled(bool on) {
+            enabled.store(on, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Records a latency for an operation, if enabled.
+         * @param metric Timed operation.
+         * @param nanoseconds Measured latency.
+         */
+        void record(Metric metric, std::uint64_t nanoseconds) {
+            if (isEnabled()) {
+                histograms[static_cast<std::size_t>(metric)].record(nanoseconds);
+            }
+        }
+
+        /**
+         * @brief Adds to an event counter, if enabled.
+         * @param counter Counted event.
+         * @param amount Number of events.
+         */
+        void increment(Counter counter, std::uint64_t amount) {
+            if (isEnabled()) {
+                counters[static_cast<std::size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Accesses the histogram of an operation.
+         * @param metric Timed operation.
+         * @return Its histogram.
+         */
+        const LatencyHistogram& histogram(Metric metric) {
+            return histograms[static_cast<std::size_t>(metric)];
+        }
+
+        /**
+         * @brief Reads an event counter.
+         * @param counter Counted event.
+         * @return Events counted so far.
+         */
+        std::uint64_t counter(Counter counter) {
+            return counters[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Prints every histogram and counter.
+         *
+         * Latencies are shown in microseconds.
+         *
+         * @param out Stream to print to.
+         */
+        void printReport(std::ostream& out) {
+            out << "--- Performance Metrics ---" << std::endl;
+            if (!isEnabled()) {
+                out << "(instrumentation is disabled)" << std::endl;
+            }
+
+            out << std::left << std::setw(18) << "operation" << std::right
+                << std::setw(10) << "count" << std::setw(12) << "mean_us" << std::setw(12) << "p50_us"
+                << std::setw(12) << "p99_us" << std::setw(12) << "max_us" << std::endl;
+            out << std::fixed << std::setprecision(2);
+            for (std::size_t m = 0; m < static_cast<std::size_t>(Metric::Count); ++m) {
+                const LatencyHistogram& h = histograms[m];
+                out << std::left << std::setw(18) << metricNames[m] << std::right
+                    << std::setw(10) << h.getCount()
+                    << std::setw(12) << toMicroseconds(h.getMean())
+                    << std::setw(12) << toMicroseconds(static_cast<double>(h.getPercentile(50.0)))
+                    << std::setw(12) << toMicroseconds(static_cast<double>(h.getPercentile(99.0)))
+                    << std::setw(12) << toMicroseconds(static_cast<double>(h.getMax())) << std::endl;
+            }
+
+            out << std::endl;
+            for (std::size_t c = 0; c < static_cast<std::size_t>(Counter::Count); ++c) {
+                out << std::left << std::setw(28) << counterNames[c] << std::right << counters[c].load() << std::endl;
+            }
+            out.unsetf(std::ios::fixed);
+        }
+
+        /**
+         * @brief Writes the report to a file.
+         * @param path File to overwrite.
+         * @return False if the file could not be written.
+         */
+        bool dumpToFile(const std::string& path) {
+            std::ofstream out(path, std::ios::trunc);
+            if (!out) {
+                std::cerr << "Error opening " << path << " for writing." << std::endl;
+                return false;
+            }
+
+            printReport(out);
+            return static_cast<bool>(out);
+        }
+    }
+}
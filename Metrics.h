@@ -0,0 +1,230 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+namespace bankSimulation {
+
+	/**
+	 * @class LatencyHistogram
+	 * @brief Lock-free log-linear histogram of latencies in nanoseconds.
+	 *
+	 * Follows the HDR histogram layout: values below 16 get a bucket each, and every
+	 * power of two above that is split into 16 equal sub-buckets, so any recorded value
+	 * is reported within 1/16 (about 6%) of its true size across the whole 64-bit range.
+	 * Recording is a handful of relaxed atomic operations and never allocates.
+	 */
+	class LatencyHistogram {
+	public:
+		/// Sub-buckets per power of two, as a power of two
+		static const int subBucketBits = 4;
+
+		/// Number of buckets needed to cover every 64-bit value
+		static const std::size_t bucketCount = (64 - subBucketBits + 1) << subBucketBits;
+
+	private:
+		std::atomic<std::uint64_t> buckets[bucketCount];  ///< Values recorded in each bucket
+		std::atomic<std::uint64_t> count{ 0 };            ///< Values recorded in total
+		std::atomic<std::uint64_t> total{ 0 };            ///< Sum of all recorded values
+		std::atomic<std::uint64_t> maximum{ 0 };          ///< Largest recorded value
+
+		/**
+		 * @brief Finds the bucket holding a value.
+		 * @param value Value to place.
+		 * @return Bucket index.
+		 */
+		static std::size_t bucketFor(std::uint64_t value);
+
+		/**
+		 * @brief Gets the largest value a bucket can hold.
+		 * @param bucket Bucket index.
+		 * @return Inclusive upper bound of the bucket.
+		 */
+		static std::uint64_t bucketUpperBound(std::size_t bucket);
+
+	public:
+		LatencyHistogram();
+		LatencyHistogram(const LatencyHistogram&) = delete;
+		LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+		/**
+		 * @brief Records one latency. Safe to call from any thread.
+		 * @param nanoseconds Measured latency.
+		 */
+		void record(std::uint64_t nanoseconds);
+
+		/**
+		 * @brief Gets the number of recorded values.
+		 * @return Count.
+		 */
+		std::uint64_t getCount() const;
+
+		/**
+		 * @brief Gets the mean of the recorded values.
+		 * @return Mean in nanoseconds, or 0 if nothing was recorded.
+		 */
+		double getMean() const;
+
+		/**
+		 * @brief Gets the largest recorded value.
+		 * @return Maximum in nanoseconds.
+		 */
+		std::uint64_t getMax() const;
+
+		/**
+		 * @brief Estimates a percentile of the recorded values.
+		 * @param percentile Percentile between 0 and 100.
+		 * @return Upper bound of the bucket holding the percentile, at most getMax().
+		 */
+		std::uint64_t getPercentile(double percentile) const;
+
+		/**
+		 * @brief Discards every recorded value.
+		 */
+		void reset();
+	};
+
+	/**
+	 * @enum Metric
+	 * @brief Timed operations.
+	 */
+	enum class Metric {
+		Deposit,            ///< Account::applyDeposit
+		Withdrawal,         ///< Account::applyWithdrawal
+		LogTransaction,     ///< Account::logTransaction, including the journal append
+		SaveAccount,        ///< Storage::saveAccount
+		SaveBank,           ///< Storage::saveBank
+		LoadAccount,        ///< Storage::loadAccount, including journal replay
+		LoginLookup,        ///< Last name lookup in userLogIn
+		Checkpoint,         ///< Storage::checkpoint or a background checkpoint, start to finish
+		CheckpointPause,    ///< Time a background checkpoint holds transactions off to capture the state
+		Count               ///< Number of metrics, not a metric
+	};
+
+	/**
+	 * @enum Counter
+	 * @brief Counted events.
+	 */
+	enum class Counter {
+		DepositsApplied,    ///< Deposits that changed a balance
+		WithdrawalsApplied, ///< Withdrawals that changed a balance
+		InsufficientFunds,  ///< Withdrawals refused for lack of funds
+		InvalidAmounts,     ///< Transactions refused for their amount
+		JournalRecords,     ///< Records appended to journal.dat
+		JournalWriteFailures, ///< Records the journal failed to write or sync
+		Checkpoints,        ///< Full checkpoints written
+		CheckpointBytesReclaimed, ///< Journal and accounts.dat garbage bytes freed by checkpoints
+		HistoryPageIns,     ///< Histories read back from accounts.dat
+		HistoryEvictions,   ///< Histories released to meet the lazy history budget
+		Count               ///< Number of counters, not a counter
+	};
+
+	/**
+	 * @brief Process-wide latency histograms and event counters.
+	 *
+	 * Instrumentation starts disabled. While disabled, every timer and counter costs one
+	 * relaxed atomic load and a branch.
+	 */
+	namespace metrics {
+
+		/// Whether timers and counters record anything
+		extern std::atomic<bool> enabled;
+
+		/**
+		 * @brief Checks whether instrumentation is recording.
+		 * @return True if enabled.
+		 */
+		inline bool isEnabled() {
+			return enabled.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Turns instrumentation on or off.
+		 * @param on True to start recording.
+		 */
+		void setEnabled(bool on);
+
+		/**
+		 * @brief Records a latency for an operation, if enabled.
+		 * @param metric Timed operation.
+		 * @param nanoseconds Measured latency.
+		 */
+		void record(Metric metric, std::uint64_t nanoseconds);
+
+		/**
+		 * @brief Adds to an event counter, if enabled.
+		 * @param counter Counted event.
+		 * @param amount Number of events.
+		 */
+		void increment(Counter counter, std::uint64_t amount = 1);
+
+		/**
+		 * @brief Accesses the histogram of an operation.
+		 * @param metric Timed operation.
+		 * @return Its histogram.
+		 */
+		const LatencyHistogram& histogram(Metric metric);
+
+		/**
+		 * @brief Reads an event counter.
+		 * @param counter Counted event.
+		 * @return Events counted so far.
+		 */
+		std::uint64_t counter(Counter counter);
+
+		/**
+		 * @brief Prints count, mean, p50, p99 and max for every operation, then every counter.
+		 * @param out Stream to print to.
+		 */
+		void printReport(std::ostream& out);
+
+		/**
+		 * @brief Writes the report to a file.
+		 * @param path File to overwrite.
+		 * @return False if the file could not be written.
+		 */
+		bool dumpToFile(const std::string& path);
+	}
+
+	/**
+	 * @class ScopedTimer
+	 * @brief Records the lifetime of a scope into an operation's histogram.
+	 *
+	 * Checks whether instrumentation is enabled once, on construction, and does nothing
+	 * else when it is not.
+	 */
+	class ScopedTimer {
+	private:
+		Metric metric;                                     ///< Operation being timed
+		bool active;                                       ///< Whether this timer records
+		std::chrono::steady_clock::time_point start;       ///< When the scope was entered
+
+	public:
+		/**
+		 * @brief Starts timing an operation.
+		 * @param metric Operation being timed.
+		 */
+		explicit ScopedTimer(Metric metric) : metric(metric), active(metrics::isEnabled()) {
+			if (active) {
+				start = std::chrono::steady_clock::now();
+			}
+		}
+
+		/**
+		 * @brief Records the elapsed time.
+		 */
+		~ScopedTimer() {
+			if (active) {
+				auto elapsed = std::chrono::steady_clock::now() - start;
+				metrics::record(metric, static_cast<std::uint64_t>(
+					std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+			}
+		}
+
+		ScopedTimer(const ScopedTimer&) = delete;
+		ScopedTimer& operator=(const ScopedTimer&) = delete;
+	};
+}
@@ -0,0 +1,62 @@
+#include "NameTable.h"
+
+namespace bankSimulation {
+
+    const NameTable::NameId NameTable::noName;
+
+    /**
+     * @brief Gets the id of a name, interning it on first use.
+     *
+     * Looking the name up first means an existing name costs one hash lookup and
+     * no allocation.
+     *
+     * @param name Name to intern.
+     * @return Id of the name.
+     */
+    NameTable::NameId NameTable::intern(std::string_view name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+
+        NameId id = static_cast<NameId>(names.size());
+        names.emplace_back(name);
+        ids.emplace(names.back(), id);
+        return id;
+    }
+
+    /**
+     * @brief Looks a name up without interning it.
+     * @param name Name to look up.
+     * @return Id of the name, or noName if it was never interned.
+     */
+    NameTable::NameId NameTable::find(std::string_view name) const {
+        auto it = ids.find(name);
+        return it == ids.end() ? noName : it->second;
+    }
+
+    /**
+     * @brief Gets the interned name with the given id.
+     * @param id Id returned by intern.
+     * @return View of the interned name.
+     */
+    std::string_view NameTable::get(NameId id) const {
+        return names[id];
+    }
+
+    /**
+     * @brief Gets the number of distinct names interned.
+     * @return Name count.
+     */
+    std::size_t NameTable::size() const {
+        return names.size();
+    }
+
+    /**
+     * @brief Forgets every name.
+     */
+    void NameTable::clear() {
+        ids.clear();
+        names.clear();
+    }
+}
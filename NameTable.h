@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace bankSimulation {
+
+	/**
+	 * @class NameTable
+	 * @brief Interning table that stores each distinct name once and refers to it by a small id.
+	 *
+	 * Ids are handed out densely from 0 in first-seen order, so they can index a vector.
+	 * Interned names never move, so the views returned by get() stay valid until clear().
+	 */
+	class NameTable {
+	public:
+		/// Dense id of an interned name
+		using NameId = std::uint32_t;
+
+		/// Id returned by lookups for names that were never interned
+		static const NameId noName = static_cast<NameId>(-1);
+
+	private:
+		std::deque<std::string> names;                       ///< Interned names by id; a deque never relocates them
+		std::unordered_map<std::string_view, NameId> ids;    ///< Views of the interned names to their ids
+
+	public:
+		/**
+		 * @brief Gets the id of a name, interning it on first use.
+		 * @param name Name to intern.
+		 * @return Id of the name.
+		 */
+		NameId intern(std::string_view name);
+
+		/**
+		 * @brief Looks a name up without interning it.
+		 * @param name Name to look up.
+		 * @return Id of the name, or noName if it was never interned.
+		 */
+		NameId find(std::string_view name) const;
+
+		/**
+		 * @brief Gets the interned name with the given id.
+		 * @param id Id returned by intern.
+		 * @return View of the interned name.
+		 */
+		std::string_view get(NameId id) const;
+
+		/**
+		 * @brief Gets the number of distinct names interned.
+		 * @return Name count, which is also the next id to be handed out.
+		 */
+		std::size_t size() const;
+
+		/**
+		 * @brief Forgets every name; previously returned ids and views become invalid.
+		 */
+		void clear();
+	};
+}
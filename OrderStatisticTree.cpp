@@ -0,0 +1,304 @@
+#include "OrderStatisticTree.h"
+#include <algorithm>
+#include <numeric>
+
+namespace bankSimulation {
+
+    const OrderStatisticTree::Id OrderStatisticTree::none;
+
+    /**
+     * @brief Recomputes a node's subtree size from its children.
+     * @param node Node whose children are final.
+     */
+    void OrderStatisticTree::refresh(Id node) {
+        nodes[node].size = 1 + sizeOf(nodes[node].left) + sizeOf(nodes[node].right);
+    }
+
+    /**
+     * @brief Splits a subtree into the entries ordered before (key, id) and the rest.
+     *
+     * @param node Root of the subtree.
+     * @param key Key of the split point.
+     * @param id Id of the split point.
+     * @param before Receives the root of the smaller entries.
+     * @param after Receives the root of the remaining entries.
+     */
+    void OrderStatisticTree::split(Id node, double key, Id id, Id& before, Id& after) {
+        if (node == none) {
+            before = after = none;
+            return;
+        }
+
+        if (less(nodes[node].key, node, key, id)) {
+            split(nodes[node].right, key, id, nodes[node].right, after);
+            before = node;
+        }
+        else {
+            split(nodes[node].left, key, id, before, nodes[node].left);
+            after = node;
+        }
+        refresh(node);
+    }
+
+    /**
+     * @brief Joins two subtrees, keeping the higher priority on top.
+     *
+     * @param before Subtree of smaller entries.
+     * @param after Subtree of larger entries.
+     * @return Root of the joined subtree.
+     */
+    OrderStatisticTree::Id OrderStatisticTree::merge(Id before, Id after) {
+        if (before == none) {
+            return after;
+        }
+        if (after == none) {
+            return before;
+        }
+
+        if (nodes[before].priority > nodes[after].priority) {
+            nodes[before].right = merge(nodes[before].right, after);
+            refresh(before);
+            return before;
+        }
+        nodes[after].left = merge(before, nodes[after].left);
+        refresh(after);
+        return after;
+    }
+
+    /**
+     * @brief Derives a node's priority by mixing the bits of its id.
+     * @param id Node id.
+     * @return Well-spread priority.
+     */
+    std::uint32_t OrderStatisticTree::priorityOf(Id id) {
+        std::uint32_t x = id + 0x9e3779b9u;
+        x = (x ^ (x >> 16)) * 0x85ebca6bu;
+        x = (x ^ (x >> 13)) * 0xc2b2ae35u;
+        return x ^ (x >> 16);
+    }
+
+    /**
+     * @brief Removes every entry and forgets every id.
+     */
+    void OrderStatisticTree::clear() {
+        nodes.clear();
+        root = none;
+        count = 0;
+    }
+
+    /**
+     * @brief Replaces the contents with one entry per id.
+     *
+     * Sorts the ids by key, then builds the treap left to right with a stack holding
+     * its right spine (the standard Cartesian tree construction), which takes linear
+     * time. Subtree sizes are filled in afterwards in one bottom-up pass.
+     *
+     * @param keys Key of every entry, indexed by id.
+     */
+    void OrderStatisticTree::build(const std::vector<double>& keys) {
+        nodes.assign(keys.size(), Node());
+        std::vector<Id> order(keys.size());
+        std::iota(order.begin(), order.end(), Id(0));
+        std::sort(order.begin(), order.end(), [&keys](Id a, Id b) {
+            return keys[a] < keys[b] || (keys[a] == keys[b] && a < b);
+        });
+
+        std::vector<Id> spine;
+        for (Id id : order) {
+            Node& node = nodes[id];
+            node.key = keys[id];
+            node.left = node.right = none;
+            node.priority = priorityOf(id);
+
+            Id lastPopped = none;
+            while (!spine.empty() && nodes[spine.back()].priority < node.priority) {
+                lastPopped = spine.back();
+                spine.pop_back();
+            }
+            node.left = lastPopped;
+            if (!spine.empty()) {
+                nodes[spine.back()].right = id;
+            }
+            spine.push_back(id);
+        }
+        root = spine.empty() ? none : spine.front();
+        count = keys.size();
+
+        // Children come before parents in reverse pre-order, so one pass fixes every size
+        std::vector<Id> preorder;
+        preorder.reserve(keys.size());
+        std::vector<Id> pending;
+        if (root != none) {
+            pending.push_back(root);
+        }
+        while (!pending.empty()) {
+            Id id = pending.back();
+            pending.pop_back();
+            preorder.push_back(id);
+            if (nodes[id].left != none) {
+                pending.push_back(nodes[id].left);
+            }
+            if (nodes[id].right != none) {
+                pending.push_back(nodes[id].right);
+            }
+        }
+        for (auto it = preorder.rbegin(); it != preorder.rend(); ++it) {
+            refresh(*it);
+        }
+    }
+
+    /**
+     * @brief Adds an entry where its priority places it.
+     *
+     * Descends while the nodes passed outrank the new entry, counting it into each of
+     * their subtrees, then splits only the subtree it takes over. That subtree is small
+     * on average, so most of the work is the one descent.
+     *
+     * @param id Id of the entry; a new id must be the next unused one.
+     * @param key Ordering key.
+     */
+    void OrderStatisticTree::insert(Id id, double key) {
+        if (id == nodes.size()) {
+            nodes.push_back(Node());
+        }
+
+        Node& node = nodes[id];
+        node.key = key;
+        node.left = node.right = none;
+        node.size = 1;
+        node.priority = priorityOf(id);
+
+        Id* link = &root;
+        while (*link != none && nodes[*link].priority >= node.priority) {
+            Node& parent = nodes[*link];
+            ++parent.size;
+            link = less(key, id, parent.key, *link) ? &parent.left : &parent.right;
+        }
+        split(*link, key, id, node.left, node.right);
+        refresh(id);
+        *link = id;
+        ++count;
+    }
+
+    /**
+     * @brief Removes an entry, replacing it by the merge of its children.
+     *
+     * Counts the entry out of every subtree on the way down to it.
+     *
+     * @param id Id of an entry in the tree.
+     */
+    void OrderStatisticTree::erase(Id id) {
+        Node& node = nodes[id];
+        Id* link = &root;
+        while (*link != id) {
+            Node& parent = nodes[*link];
+            --parent.size;
+            link = less(node.key, id, parent.key, *link) ? &parent.left : &parent.right;
+        }
+        *link = merge(node.left, node.right);
+        node.left = node.right = none;
+        node.size = 0;
+        --count;
+    }
+
+    /**
+     * @brief Moves an entry to a new key by taking it out and putting it back.
+     *
+     * @param id Id of an entry in the tree.
+     * @param key New ordering key.
+     */
+    void OrderStatisticTree::update(Id id, double key) {
+        erase(id);
+        insert(id, key);
+    }
+
+    /**
+     * @brief Gets the number of entries.
+     * @return Entry count.
+     */
+    std::size_t OrderStatisticTree::size() const {
+        return count;
+    }
+
+    /**
+     * @brief Checks whether an id is in the tree.
+     * @param id Id to check.
+     * @return True if the entry is present.
+     */
+    bool OrderStatisticTree::contains(Id id) const {
+        return id < nodes.size() && nodes[id].size > 0;
+    }
+
+    /**
+     * @brief Gets the key an entry is stored under.
+     * @param id Id of an entry in the tree.
+     * @return Its key.
+     */
+    double OrderStatisticTree::keyOf(Id id) const {
+        return nodes[id].key;
+    }
+
+    /**
+     * @brief Counts the entries ordered before an entry in one descent.
+     * @param id Id of an entry in the tree.
+     * @return Zero-based position in ascending order.
+     */
+    std::size_t OrderStatisticTree::rankOf(Id id) const {
+        std::size_t rank = 0;
+        Id node = root;
+        while (node != none && node != id) {
+            if (less(nodes[node].key, node, nodes[id].key, id)) {
+                rank += sizeOf(nodes[node].left) + 1;
+                node = nodes[node].right;
+            }
+            else {
+                node = nodes[node].left;
+            }
+        }
+        return node == none ? rank : rank + sizeOf(nodes[node].left);
+    }
+
+    /**
+     * @brief Counts the entries with a key below a value in one descent.
+     * @param key Value to compare with.
+     * @param inclusive True to count keys equal to the value as well.
+     * @return Entry count.
+     */
+    std::size_t OrderStatisticTree::countBelow(double key, bool inclusive) const {
+        std::size_t below = 0;
+        Id node = root;
+        while (node != none) {
+            if (nodes[node].key < key || (inclusive && nodes[node].key == key)) {
+                below += sizeOf(nodes[node].left) + 1;
+                node = nodes[node].right;
+            }
+            else {
+                node = nodes[node].left;
+            }
+        }
+        return below;
+    }
+
+    /**
+     * @brief Finds the entry at a position in ascending order in one descent.
+     * @param rank Zero-based position.
+     * @return Its id, or none if rank is past the end.
+     */
+    OrderStatisticTree::Id OrderStatisticTree::select(std::size_t rank) const {
+        Id node = root;
+        while (node != none) {
+            std::size_t leftSize = sizeOf(nodes[node].left);
+            if (rank < leftSize) {
+                node = nodes[node].left;
+            }
+            else if (rank == leftSize) {
+                return node;
+            }
+            else {
+                rank -= leftSize + 1;
+                node = nodes[node].right;
+            }
+        }
+        return none;
+    }
+}
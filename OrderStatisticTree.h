@@ -0,0 +1,240 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bankSimulation {
+
+	/**
+	 * @class OrderStatisticTree
+	 * @brief Balanced search tree over (key, id) pairs that also answers rank and k-th queries.
+	 *
+	 * A treap whose nodes are numbered by id and live in one vector, so the tree never
+	 * allocates per entry. Every node records the size of its subtree, which turns
+	 * "how many keys are smaller" and "which key is k-th" into single O(log n) descents.
+	 * Equal keys are ordered by id, so every entry is distinct.
+	 *
+	 * Priorities are a hash of the id rather than random draws, so the shape of the tree
+	 * depends only on its contents and is the same on every run.
+	 *
+	 * Not thread-safe.
+	 */
+	class OrderStatisticTree {
+	public:
+		/// Dense node number; the caller's own index for the entry
+		using Id = std::uint32_t;
+
+		/// Marks a missing child or an absent result
+		static const Id none = static_cast<Id>(-1);
+
+	private:
+		/// Stack room reserved by the walks; comfortably above a treap's depth at any size
+		static const std::size_t expectedDepth = 128;
+
+		/**
+		 * @struct Node
+		 * @brief One entry and its links.
+		 */
+		struct Node {
+			double key;            ///< Ordering key
+			Id left;               ///< Subtree of smaller entries
+			Id right;              ///< Subtree of larger entries
+			std::uint32_t size;    ///< Entries in this subtree, this one included; 0 while not in the tree
+			std::uint32_t priority;///< Heap priority; a parent's is never lower than its children's
+		};
+
+		std::vector<Node> nodes;   ///< Nodes by id
+		Id root = none;            ///< Top of the tree
+		std::size_t count = 0;     ///< Entries currently in the tree
+
+		/**
+		 * @brief Orders two entries by key, then by id.
+		 */
+		bool less(double key, Id id, double otherKey, Id otherId) const {
+			return key < otherKey || (key == otherKey && id < otherId);
+		}
+
+		/**
+		 * @brief Gets the size of a possibly missing subtree.
+		 */
+		std::uint32_t sizeOf(Id node) const {
+			return node == none ? 0 : nodes[node].size;
+		}
+
+		/**
+		 * @brief Recomputes a node's subtree size from its children.
+		 */
+		void refresh(Id node);
+
+		/**
+		 * @brief Splits a subtree into entries before (key, id) and the rest.
+		 */
+		void split(Id node, double key, Id id, Id& before, Id& after);
+
+		/**
+		 * @brief Joins two subtrees where every entry of the first comes before the second.
+		 * @return Root of the joined subtree.
+		 */
+		Id merge(Id before, Id after);
+
+		/**
+		 * @brief Derives a node's priority from its id.
+		 */
+		static std::uint32_t priorityOf(Id id);
+
+	public:
+		/**
+		 * @brief Removes every entry and forgets every id.
+		 */
+		void clear();
+
+		/**
+		 * @brief Replaces the contents with one entry per id in linear time after sorting.
+		 * @param keys Key of every entry, indexed by id.
+		 */
+		void build(const std::vector<double>& keys);
+
+		/**
+		 * @brief Adds an entry in O(log n).
+		 *
+		 * @param id Id of the entry; a new id must be the next unused one.
+		 * @param key Ordering key.
+		 */
+		void insert(Id id, double key);
+
+		/**
+		 * @brief Removes an entry in O(log n).
+		 * @param id Id of an entry in the tree.
+		 */
+		void erase(Id id);
+
+		/**
+		 * @brief Moves an entry to a new key in O(log n).
+		 *
+		 * @param id Id of an entry in the tree.
+		 * @param key New ordering key.
+		 */
+		void update(Id id, double key);
+
+		/**
+		 * @brief Gets the number of entries.
+		 * @return Entry count.
+		 */
+		std::size_t size() const;
+
+		/**
+		 * @brief Checks whether an id is in the tree.
+		 * @param id Id to check.
+		 * @return True if the entry is present.
+		 */
+		bool contains(Id id) const;
+
+		/**
+		 * @brief Gets the key an entry is stored under.
+		 * @param id Id of an entry in the tree.
+		 * @return Its key.
+		 */
+		double keyOf(Id id) const;
+
+		/**
+		 * @brief Counts the entries ordered before an entry.
+		 * @param id Id of an entry in the tree.
+		 * @return Zero-based position in ascending order.
+		 */
+		std::size_t rankOf(Id id) const;
+
+		/**
+		 * @brief Counts the entries with a key below a value.
+		 * @param key Value to compare with.
+		 * @param inclusive True to count keys equal to the value as well.
+		 * @return Entry count.
+		 */
+		std::size_t countBelow(double key, bool inclusive) const;
+
+		/**
+		 * @brief Finds the entry at a position in ascending order.
+		 * @param rank Zero-based position.
+		 * @return Its id, or none if rank is past the end.
+		 */
+		Id select(std::size_t rank) const;
+
+		/**
+		 * @brief Visits entries from a position in ascending order.
+		 *
+		 * @param rank Zero-based position of the first entry.
+		 * @param visit Called with each id; returning false stops the walk.
+		 */
+		template <typename Visit>
+		void forEachFrom(std::size_t rank, Visit visit) const {
+			// Descend to the starting entry, remembering every ancestor still to be visited
+			std::vector<Id> pending;
+			pending.reserve(expectedDepth);
+			Id node = root;
+			while (node != none) {
+				std::size_t leftSize = sizeOf(nodes[node].left);
+				if (rank < leftSize) {
+					pending.push_back(node);
+					node = nodes[node].left;
+				}
+				else if (rank == leftSize) {
+					pending.push_back(node);
+					break;
+				}
+				else {
+					rank -= leftSize + 1;
+					node = nodes[node].right;
+				}
+			}
+
+			while (!pending.empty()) {
+				node = pending.back();
+				pending.pop_back();
+				if (!visit(node)) {
+					return;
+				}
+				for (Id next = nodes[node].right; next != none; next = nodes[next].left) {
+					pending.push_back(next);
+				}
+			}
+		}
+
+		/**
+		 * @brief Visits entries from a position in descending order.
+		 *
+		 * @param rank Zero-based ascending position of the first entry visited.
+		 * @param visit Called with each id; returning false stops the walk.
+		 */
+		template <typename Visit>
+		void forEachDownFrom(std::size_t rank, Visit visit) const {
+			std::vector<Id> pending;
+			pending.reserve(expectedDepth);
+			Id node = root;
+			while (node != none) {
+				std::size_t leftSize = sizeOf(nodes[node].left);
+				if (rank < leftSize) {
+					node = nodes[node].left;
+				}
+				else if (rank == leftSize) {
+					pending.push_back(node);
+					break;
+				}
+				else {
+					pending.push_back(node);
+					rank -= leftSize + 1;
+					node = nodes[node].right;
+				}
+			}
+
+			while (!pending.empty()) {
+				node = pending.back();
+				pending.pop_back();
+				if (!visit(node)) {
+					return;
+				}
+				for (Id next = nodes[node].left; next != none; next = nodes[next].right) {
+					pending.push_back(next);
+				}
+			}
+		}
+	};
+}
@@ -0,0 +1,353 @@
+#include "PersistenceWorker.h"
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+
+namespace bankSimulation {
+
+    /**
+     * @brief Creates a worker in Sync mode; the thread starts with the first queued mode.
+     * @param journal Journal to append to.
+     */
+    PersistenceWorker::PersistenceWorker(Journal& journal) : journal(journal) {}
+
+    /**
+     * @brief Drains the queue and joins the thread, so no acknowledged record is lost.
+     */
+    PersistenceWorker::~PersistenceWorker() {
+        setDurability(Durability::Sync);
+    }
+
+    /**
+     * @brief Writes queued records in batches of up to maxBatch, one fsync per batch.
+     *
+     * Once a record is queued the worker waits out the commit window, or until the
+     * batch is full, then takes the oldest records and writes them. Submitters keep
+     * queueing while a batch is being synced; those records form the next batch. Exits
+     * once stopping is set and the queue is empty.
+     *
+     * Batches are taken in submission order by this one thread, so the tickets of a
+     * batch directly follow those of every record already resolved.
+     */
+    void PersistenceWorker::run() {
+        std::vector<Journal::Record> batch;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            wake.wait(lock, [this]() { return stopping || !pending.empty(); });
+            if (pending.empty()) {
+                return;
+            }
+
+            if (commitWindow.count() > 0) {
+                wake.wait_for(lock, commitWindow, [this]() { return stopping || pending.size() >= maxBatch; });
+            }
+
+            if (pending.size() <= maxBatch) {
+                batch.swap(pending);
+            }
+            else {
+                batch.assign(pending.begin(), pending.begin() + maxBatch);
+                pending.erase(pending.begin(), pending.begin() + maxBatch);
+            }
+            std::uint64_t firstTicket = completed + failed + 1;
+            lock.unlock();
+            bool durable = journal.appendBatch(batch) != 0;
+            lock.lock();
+
+            if (durable) {
+                completed += batch.size();
+            }
+            else {
+                failed += batch.size();
+                failedTickets.emplace_back(firstTicket, firstTicket + batch.size() - 1);
+            }
+            ++batches;
+            batch.clear();
+            written.notify_all();
+        }
+    }
+
+    /**
+     * @brief Changes the durability mode.
+     *
+     * Leaving a queued mode stops the worker after it has written everything queued.
+     * Entering one starts a fresh worker.
+     *
+     * @param mode New mode.
+     */
+    void PersistenceWorker::setDurability(Durability mode) {
+        if (worker.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_one();
+            worker.join();
+            stopping = false;
+        }
+
+        durability = mode;
+        if (mode != Durability::Sync) {
+            worker = std::thread(&PersistenceWorker::run, this);
+        }
+    }
+
+    /**
+     * @brief Gets the current durability mode.
+     * @return Mode in effect.
+     */
+    PersistenceWorker::Durability PersistenceWorker::getDurability() const {
+        return durability;
+    }
+
+    /**
+     * @brief Sets how long the worker may wait for a batch to fill.
+     * @param window Longest extra wait; negative values count as zero.
+     */
+    void PersistenceWorker::setCommitWindow(std::chrono::microseconds window) {
+        std::lock_guard<std::mutex> lock(mutex);
+        commitWindow = std::max(window, std::chrono::microseconds(0));
+    }
+
+    /**
+     * @brief Gets the commit window.
+     * @return Longest extra wait before a batch is written.
+     */
+    std::chrono::microseconds PersistenceWorker::getCommitWindow() const {
+        return commitWindow;
+    }
+
+    /**
+     * @brief Sets the most records written with one fsync.
+     * @param records Batch size limit; 0 is treated as 1.
+     */
+    void PersistenceWorker::setMaxBatch(std::size_t records) {
+        std::lock_guard<std::mutex> lock(mutex);
+        maxBatch = std::max<std::size_t>(records, 1);
+    }
+
+    /**
+     * @brief Gets the batch size limit.
+     * @return Most records per fsync.
+     */
+    std::size_t PersistenceWorker::getMaxBatch() const {
+        return maxBatch;
+    }
+
+    /**
+     * @brief Hands over a record for the journal.
+     *
+     * In Sync mode the record is appended and synced on the calling thread, under the
+     * lock so concurrent callers do not interleave. Otherwise it is queued; in
+     * GroupCommit mode the caller then waits until the batch containing it is synced,
+     * so a transaction is never acknowledged before its record is durable.
+     *
+     * The worker is only woken when it has something new to act on: the first record
+     * of a batch, or the record that fills one during a commit window.
+     *
+     * @param record Record to append.
+     * @return False if the record is known not to be durable.
+     */
+    bool PersistenceWorker::submit(const Journal::Record& record) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (durability == Durability::Sync) {
+            Journal::Record copy = record;
+            std::uint64_t ticket = ++submitted;
+            if (journal.append(copy) == 0) {
+                ++failed;
+                failedTickets.emplace_back(ticket, ticket);
+                return false;
+            }
+            ++completed;
+            return true;
+        }
+
+        pending.push_back(record);
+        std::uint64_t ticket = ++submitted;
+        if (pending.size() == 1 || pending.size() == maxBatch) {
+            wake.notify_one();
+        }
+
+        if (durability == Durability::GroupCommit) {
+            written.wait(lock, [this, ticket]() { return completed + failed >= ticket; });
+            return !anyFailed(ticket, ticket);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Waits until the worker has written, or failed to write, every record submitted so far.
+     *
+     * Reports each failure once: to the first flush that covers it.
+     *
+     * @return False if a record submitted since the previous flush was not written.
+     */
+    bool PersistenceWorker::flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        std::uint64_t target = submitted.load();
+        written.wait(lock, [this, target]() { return completed + failed >= target; });
+
+        bool durable = target <= flushedThrough || !anyFailed(flushedThrough + 1, target);
+        flushedThrough = std::max(flushedThrough, target);
+        return durable;
+    }
+
+    /**
+     * @brief Checks the failed ranges for any ticket in a range.
+     *
+     * Failures are rare, so a linear scan of every one so far is enough. Called with
+     * the lock held.
+     *
+     * @param first First ticket of the range.
+     * @param last Last ticket of the range.
+     * @return True if at least one record in the range was not written.
+     */
+    bool PersistenceWorker::anyFailed(std::uint64_t first, std::uint64_t last) const {
+        for (const auto& range : failedTickets) {
+            if (range.first <= last && range.second >= first) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Gets the number of batches the worker has written.
+     * @return Batch count.
+     */
+    std::uint64_t PersistenceWorker::getBatchCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return batches;
+    }
+
+    /**
+     * @brief Gets the number of records submitted but not yet written.
+     *
+     * Reads completed and failed before submitted, so a write finishing in between can
+     * only make the answer too high, never wrap below zero.
+     *
+     * @return Backlog size.
+     */
+    std::size_t PersistenceWorker::backlog() const {
+        std::uint64_t done = completed.load() + failed.load();
+        return static_cast<std::size_t>(submitted.load() - done);
+    }
+
+    namespace {
+        /**
+         * @brief Timings of one commit benchmark run.
+         */
+        struct CommitRun {
+            double seconds = 0;                  ///< Wall time of the whole run
+            std::vector<double> latencies;       ///< Acknowledgement latency of every submit, in microseconds
+        };
+
+        /**
+         * @brief Submits records from several threads and times every acknowledgement.
+         *
+         * @param worker Worker to submit to, already in the mode being measured.
+         * @param threads Submitter thread count.
+         * @param recordsPerThread Records each thread submits.
+         * @return Wall time and sorted latencies.
+         */
+        CommitRun timeSubmits(PersistenceWorker& worker, unsigned threads, std::size_t recordsPerThread) {
+            using Clock = std::chrono::steady_clock;
+            CommitRun run;
+            std::vector<std::vector<double>> perThread(threads);
+            std::vector<std::thread> submitters;
+
+            auto start = Clock::now();
+            for (unsigned t = 0; t < threads; ++t) {
+                submitters.emplace_back([&worker, &perThread, t, recordsPerThread]() {
+                    std::vector<double>& latencies = perThread[t];
+                    latencies.reserve(recordsPerThread);
+                    Journal::Record record{ 0, t, 'D', 1.0, 1.0, 0 };
+                    for (std::size_t i = 0; i < recordsPerThread; ++i) {
+                        auto submitted = Clock::now();
+                        worker.submit(record);
+                        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - submitted).count());
+                    }
+                });
+            }
+            for (auto& submitter : submitters) {
+                submitter.join();
+            }
+            worker.flush();
+            run.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+            for (const auto& latencies : perThread) {
+                run.latencies.insert(run.latencies.end(), latencies.begin(), latencies.end());
+            }
+            std::sort(run.latencies.begin(), run.latencies.end());
+            return run;
+        }
+
+        /**
+         * @brief Gets a percentile of sorted samples.
+         * @param sorted Samples in ascending order.
+         * @param fraction Percentile between 0 and 1.
+         * @return Sample at that rank, or 0 if there are none.
+         */
+        double percentile(const std::vector<double>& sorted, double fraction) {
+            if (sorted.empty()) {
+                return 0;
+            }
+            return sorted[static_cast<std::size_t>(fraction * (sorted.size() - 1))];
+        }
+    }
+
+    /**
+     * @brief Measures group commit throughput against commit latency.
+     *
+     * The sync rows sync every record on its own thread and are the baseline. The group
+     * rows show how sharing each fsync raises throughput with more submitters, and what
+     * a longer commit window adds to latency in exchange for larger batches.
+     *
+     * @param path Scratch journal file.
+     * @param maxThreads Largest submitter thread count.
+     * @param recordsPerThread Records each thread submits per run.
+     * @param maxBatch Batch size limit for the group commit runs.
+     */
+    void runCommitBenchmark(const std::string& path, unsigned maxThreads, std::size_t recordsPerThread, std::size_t maxBatch) {
+        const long long windows[] = { -1, 0, 100, 1000 };
+
+        std::cout << "--- Commit Benchmark ---" << std::endl;
+        std::cout << "mode,threads,window_us,tx_per_sec,mean_us,p50_us,p99_us,mean_batch" << std::endl;
+
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+            for (long long window : windows) {
+                std::remove(path.c_str());
+                CommitRun run;
+                double meanBatch = 1;
+                {
+                    Journal journal(path);
+                    PersistenceWorker worker(journal);
+                    worker.setMaxBatch(maxBatch);
+                    if (window >= 0) {
+                        worker.setCommitWindow(std::chrono::microseconds(window));
+                        worker.setDurability(PersistenceWorker::Durability::GroupCommit);
+                    }
+                    run = timeSubmits(worker, threads, recordsPerThread);
+                    if (window >= 0 && worker.getBatchCount() > 0) {
+                        meanBatch = static_cast<double>(run.latencies.size()) / worker.getBatchCount();
+                    }
+                }
+
+                double total = 0;
+                for (double latency : run.latencies) {
+                    total += latency;
+                }
+                std::cout << (window < 0 ? "sync," : "group,") << threads << ","
+                    << (window < 0 ? 0 : window) << std::fixed << std::setprecision(1)
+                    << "," << run.latencies.size() / run.seconds
+                    << "," << total / run.latencies.size()
+                    << "," << percentile(run.latencies, 0.50)
+                    << "," << percentile(run.latencies, 0.99)
+                    << "," << meanBatch << std::endl;
+                std::cout.unsetf(std::ios::fixed);
+            }
+        }
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,179 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "Journal.h"
+
+namespace bankSimulation {
+
+	/**
+	 * @class PersistenceWorker
+	 * @brief Background thread that appends journal records handed to it by transactions.
+	 *
+	 * Transactions submit their record to a queue instead of writing it themselves. The
+	 * worker takes up to a batch of queued records at once and writes them with a single
+	 * fsync, so a burst of transactions costs one durable flush instead of one each. An
+	 * optional commit window makes the worker wait a little for more records before
+	 * writing, trading latency for larger batches. How long a submitter waits depends on
+	 * the durability mode.
+	 *
+	 * Every submitted record gets a ticket, its position in submission order. A batch
+	 * whose write or fsync fails is not counted as completed; its tickets are remembered
+	 * as failed, so the submitters waiting on them, and the next flush, learn that their
+	 * records are not durable.
+	 */
+	class PersistenceWorker {
+	public:
+		/**
+		 * @enum Durability
+		 * @brief When a transaction may report success relative to its journal write.
+		 */
+		enum class Durability {
+			Sync,          ///< The submitting thread writes and flushes its own record; no worker
+			GroupCommit,   ///< The worker writes; the submitter waits until its batch is synced
+			Async          ///< The worker writes; the submitter returns at once
+		};
+
+	private:
+		Journal& journal;                             ///< Journal the records are appended to
+		Durability durability = Durability::Sync;     ///< Current mode
+
+		std::mutex mutex;                             ///< Guards every member below; the counters are only written under it
+		std::condition_variable wake;                 ///< Signals the worker that records or a stop are waiting
+		std::condition_variable written;              ///< Signals submitters that a batch has been synced
+		std::vector<Journal::Record> pending;         ///< Records submitted and not yet taken by the worker
+		std::atomic<std::uint64_t> submitted{ 0 };    ///< Records ever submitted
+		std::atomic<std::uint64_t> completed{ 0 };    ///< Records ever written and synced
+		std::atomic<std::uint64_t> failed{ 0 };       ///< Records ever given up on after a failed write or sync
+		std::vector<std::pair<std::uint64_t, std::uint64_t>> failedTickets;  ///< First and last ticket of every failed write
+		std::uint64_t flushedThrough = 0;             ///< Last ticket a flush has reported on
+		std::uint64_t batches = 0;                    ///< Batches ever written by the worker
+		std::chrono::microseconds commitWindow{ 0 };  ///< How long the worker waits for a batch to fill
+		std::size_t maxBatch = 256;                   ///< Most records written with one fsync
+		bool stopping = false;                        ///< Set to make the worker drain the queue and exit
+		std::thread worker;                           ///< Runs run() while a queued mode is active
+
+		/**
+		 * @brief Writes queued records in batches until asked to stop.
+		 */
+		void run();
+
+		/**
+		 * @brief Checks whether any ticket in a range belongs to a failed write.
+		 * @param first First ticket of the range.
+		 * @param last Last ticket of the range.
+		 * @return True if at least one record in the range was not written.
+		 */
+		bool anyFailed(std::uint64_t first, std::uint64_t last) const;
+
+	public:
+		/**
+		 * @brief Creates a worker for a journal, starting in Sync mode without a thread.
+		 * @param journal Journal to append to; must outlive the worker.
+		 */
+		explicit PersistenceWorker(Journal& journal);
+
+		/**
+		 * @brief Writes everything still queued, then stops the thread.
+		 */
+		~PersistenceWorker();
+
+		PersistenceWorker(const PersistenceWorker&) = delete;
+		PersistenceWorker& operator=(const PersistenceWorker&) = delete;
+
+		/**
+		 * @brief Changes the durability mode, starting or stopping the thread as needed.
+		 *
+		 * Records queued under the old mode are written before the switch.
+		 *
+		 * @param mode New mode.
+		 */
+		void setDurability(Durability mode);
+
+		/**
+		 * @brief Gets the current durability mode.
+		 * @return Mode in effect.
+		 */
+		Durability getDurability() const;
+
+		/**
+		 * @brief Sets how long the worker may wait for more records before writing a batch.
+		 *
+		 * The window starts when the first record of a batch arrives and ends early once
+		 * the batch is full. Zero writes as soon as a record is queued; batches then form
+		 * only from records that arrive while the previous fsync is running.
+		 *
+		 * @param window Longest extra wait.
+		 */
+		void setCommitWindow(std::chrono::microseconds window);
+
+		/**
+		 * @brief Gets the commit window.
+		 * @return Longest extra wait before a batch is written.
+		 */
+		std::chrono::microseconds getCommitWindow() const;
+
+		/**
+		 * @brief Sets the most records the worker writes with one fsync.
+		 * @param records Batch size limit; 0 is treated as 1.
+		 */
+		void setMaxBatch(std::size_t records);
+
+		/**
+		 * @brief Gets the batch size limit.
+		 * @return Most records per fsync.
+		 */
+		std::size_t getMaxBatch() const;
+
+		/**
+		 * @brief Hands over a record for the journal.
+		 *
+		 * Safe to call from several threads. Records are written in submission order.
+		 *
+		 * @param record Record to append; its sequence number is assigned on write.
+		 * @return False if the record was not written (Sync) or its batch failed
+		 *         (GroupCommit); always true in Async mode, where flush reports failures.
+		 */
+		bool submit(const Journal::Record& record);
+
+		/**
+		 * @brief Waits until every record submitted so far has been written and synced, or has failed.
+		 * @return False if a record submitted since the previous flush was not written.
+		 */
+		bool flush();
+
+		/**
+		 * @brief Gets the number of batches the worker has written.
+		 * @return Batch count.
+		 */
+		std::uint64_t getBatchCount();
+
+		/**
+		 * @brief Gets the number of records submitted but not yet written or failed, without locking.
+		 * @return Backlog size.
+		 */
+		std::size_t backlog() const;
+	};
+
+	/**
+	 * @brief Measures group commit throughput against commit latency.
+	 *
+	 * Runs every submitter thread count (doubling from 1) once with per-record syncs and
+	 * once in GroupCommit mode per commit window, on a scratch journal that is removed
+	 * afterwards. Prints one CSV row per run with transactions per second, the mean,
+	 * median and 99th percentile acknowledgement latency, and the mean batch size.
+	 *
+	 * @param path Scratch journal file.
+	 * @param maxThreads Largest submitter thread count.
+	 * @param recordsPerThread Records each thread submits per run.
+	 * @param maxBatch Batch size limit for the group commit runs.
+	 */
+	void runCommitBenchmark(const std::string& path, unsigned maxThreads, std::size_t recordsPerThread, std::size_t maxBatch);
+}
@@ -0,0 +1,236 @@
+#include "QueryIndex.h"
+#include <algorithm>
+
+namespace bankSimulation {
+
+    /**
+     * @brief Forgets every account and last name.
+     */
+    void QueryIndex::clear() {
+        byBalance.clear();
+        byLastActivity.clear();
+        balances.clear();
+        lastActivity.clear();
+        largestWithdrawal.clear();
+        updateCounts.clear();
+        lastNames.clear();
+    }
+
+    /**
+     * @brief Replaces every account entry from sorted keys.
+     *
+     * Both indexes are built from sorted keys in linear time, so the whole rebuild
+     * costs little more than the two sorts.
+     *
+     * @param accountBalances Balance of every account, by handle.
+     * @param accountActivity Last transaction time of every account, by handle.
+     * @param accountWithdrawals Withdrawal bound of every account, by handle.
+     */
+    void QueryIndex::rebuild(std::vector<double> accountBalances, std::vector<std::int64_t> accountActivity,
+        std::vector<double> accountWithdrawals) {
+        balances = std::move(accountBalances);
+        lastActivity = std::move(accountActivity);
+        largestWithdrawal = std::move(accountWithdrawals);
+        updateCounts.assign(balances.size(), 0);
+        byBalance.build(balances);
+
+        std::vector<std::pair<std::int64_t, Handle>> activityKeys;
+        activityKeys.reserve(lastActivity.size());
+        for (Handle handle = 0; handle < lastActivity.size(); ++handle) {
+            activityKeys.emplace_back(lastActivity[handle], handle);
+        }
+        std::sort(activityKeys.begin(), activityKeys.end());
+        byLastActivity.clear();
+        for (const auto& key : activityKeys) {
+            byLastActivity.emplace_hint(byLastActivity.end(), key);
+        }
+    }
+
+    /**
+     * @brief Indexes the next stored account.
+     *
+     * @param handle Handle of the account.
+     * @param balance Current balance.
+     * @param activity Last transaction time, or noActivity.
+     * @param withdrawal Withdrawal bound, or unknownWithdrawal.
+     */
+    void QueryIndex::add(Handle handle, double balance, std::int64_t activity, double withdrawal) {
+        balances.push_back(balance);
+        lastActivity.push_back(activity);
+        largestWithdrawal.push_back(withdrawal);
+        updateCounts.push_back(0);
+        byBalance.insert(static_cast<OrderStatisticTree::Id>(handle), balance);
+        byLastActivity.emplace(activity, handle);
+    }
+
+    /**
+     * @brief Re-keys an account whose balance or last transaction time changed.
+     *
+     * The balance tree finds the entry from the key it is stored under. The activity
+     * entry is found from the indexed time and re-inserted at the end, since the new
+     * time is almost always the latest.
+     *
+     * @param handle Handle of an indexed account.
+     * @param balance Current balance.
+     * @param activity Last transaction time.
+     * @param withdrawn Amount withdrawn by the transaction, or 0 for a deposit.
+     */
+    void QueryIndex::update(Handle handle, double balance, std::int64_t activity, double withdrawn) {
+        largestWithdrawal[handle] = std::max(largestWithdrawal[handle], withdrawn);
+        ++updateCounts[handle];
+
+        if (balances[handle] != balance) {
+            byBalance.update(static_cast<OrderStatisticTree::Id>(handle), balance);
+            balances[handle] = balance;
+        }
+
+        if (lastActivity[handle] != activity) {
+            byLastActivity.erase(std::make_pair(lastActivity[handle], handle));
+            byLastActivity.emplace_hint(byLastActivity.end(), activity, handle);
+            lastActivity[handle] = activity;
+        }
+    }
+
+    /**
+     * @brief Narrows an account's withdrawal bound unless it changed since its history was read.
+     *
+     * A transaction appends to the history before it updates the index, so once the
+     * count matches, every transaction the read missed will still raise the bound.
+     *
+     * @param handle Handle of an indexed account.
+     * @param withdrawal Largest withdrawal in the history.
+     * @param updateCount Update count before the history was read.
+     */
+    void QueryIndex::narrowWithdrawal(Handle handle, double withdrawal, std::uint64_t updateCount) {
+        if (updateCounts[handle] == updateCount) {
+            largestWithdrawal[handle] = withdrawal;
+        }
+    }
+
+    /**
+     * @brief Adds a newly interned last name to the alphabetical order.
+     * @param name View of the interned name.
+     * @param id Interned id of the name.
+     */
+    void QueryIndex::addLastName(std::string_view name, NameTable::NameId id) {
+        lastNames.emplace(name, id);
+    }
+
+    /**
+     * @brief Counts accounts with a balance in a range from two rank descents.
+     *
+     * @param minBalance Lowest balance, inclusive.
+     * @param maxBalance Highest balance, inclusive.
+     * @return Number of accounts in the range.
+     */
+    std::size_t QueryIndex::countBalanceRange(double minBalance, double maxBalance) const {
+        if (maxBalance < minBalance) {
+            return 0;
+        }
+        return byBalance.countBelow(maxBalance, true) - byBalance.countBelow(minBalance, false);
+    }
+
+    /**
+     * @brief Gets an account's position when ordered from the largest balance down.
+     * @param handle Handle of an indexed account.
+     * @return 1 for the largest balance.
+     */
+    std::size_t QueryIndex::balanceRank(Handle handle) const {
+        return byBalance.size() - byBalance.rankOf(static_cast<OrderStatisticTree::Id>(handle));
+    }
+
+    /**
+     * @brief Gets the accounts with the largest balances by walking down from the top.
+     * @param count Most accounts to return.
+     * @return Handles, largest balance first.
+     */
+    std::vector<QueryIndex::Handle> QueryIndex::largestBalances(std::size_t count) const {
+        std::vector<Handle> handles;
+        if (count == 0 || byBalance.size() == 0) {
+            return handles;
+        }
+
+        handles.reserve(std::min(count, byBalance.size()));
+        byBalance.forEachDownFrom(byBalance.size() - 1, [&](OrderStatisticTree::Id id) {
+            handles.push_back(static_cast<Handle>(id));
+            return handles.size() < count;
+        });
+        return handles;
+    }
+
+    /**
+     * @brief Gets the accounts with the smallest balances by walking up from the bottom.
+     * @param count Most accounts to return.
+     * @return Handles, smallest balance first.
+     */
+    std::vector<QueryIndex::Handle> QueryIndex::smallestBalances(std::size_t count) const {
+        std::vector<Handle> handles;
+        if (count == 0) {
+            return handles;
+        }
+
+        handles.reserve(std::min(count, byBalance.size()));
+        byBalance.forEachFrom(0, [&](OrderStatisticTree::Id id) {
+            handles.push_back(static_cast<Handle>(id));
+            return handles.size() < count;
+        });
+        return handles;
+    }
+
+    /**
+     * @brief Counts accounts with a transaction at or after a time, stopping at a cap.
+     *
+     * @param since Earliest last transaction time.
+     * @param cap Count at which to stop walking.
+     * @return Number of such accounts, at most cap.
+     */
+    std::size_t QueryIndex::countActiveSince(std::int64_t since, std::size_t cap) const {
+        std::size_t count = 0;
+        forActiveSince(since, [&](Handle) { return ++count < cap; });
+        return std::min(count, cap);
+    }
+
+    /**
+     * @brief Gets the number of indexed accounts.
+     * @return Account count.
+     */
+    std::size_t QueryIndex::size() const {
+        return balances.size();
+    }
+
+    /**
+     * @brief Gets the balance an account is indexed under.
+     * @param handle Handle of an indexed account.
+     * @return Indexed balance.
+     */
+    double QueryIndex::getBalance(Handle handle) const {
+        return balances[handle];
+    }
+
+    /**
+     * @brief Gets the last transaction time an account is indexed under.
+     * @param handle Handle of an indexed account.
+     * @return Indexed time, or noActivity.
+     */
+    std::int64_t QueryIndex::getLastActivity(Handle handle) const {
+        return lastActivity[handle];
+    }
+
+    /**
+     * @brief Gets the upper bound on the withdrawals in an account's history.
+     * @param handle Handle of an indexed account.
+     * @return Bound, or unknownWithdrawal.
+     */
+    double QueryIndex::getLargestWithdrawal(Handle handle) const {
+        return largestWithdrawal[handle];
+    }
+
+    /**
+     * @brief Gets the number of times an account was updated.
+     * @param handle Handle of an indexed account.
+     * @return Update count.
+     */
+    std::uint64_t QueryIndex::getUpdateCount(Handle handle) const {
+        return updateCounts[handle];
+    }
+}
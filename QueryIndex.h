@@ -0,0 +1,244 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "NameTable.h"
+#include "OrderStatisticTree.h"
+
+namespace bankSimulation {
+
+	/**
+	 * @struct AccountQuery
+	 * @brief Filters for Storage::findAccounts; an account must pass every filter that is set.
+	 */
+	struct AccountQuery {
+		std::optional<double> minBalance;            ///< Lowest balance, inclusive
+		std::optional<double> maxBalance;            ///< Highest balance, inclusive
+		std::string lastNamePrefix;                  ///< Start of the last name; empty matches every name
+		std::optional<std::int64_t> activeSince;     ///< Only accounts with a transaction at or after this time
+		std::optional<double> withdrawalOver;        ///< Only accounts with a larger withdrawal, since activeSince if set
+		std::size_t limit = 100;                     ///< Most accounts returned
+		std::size_t historyScanLimit = 10'000;       ///< Most histories the withdrawal filter reads in one query
+	};
+
+	/**
+	 * @class QueryIndex
+	 * @brief Secondary indexes on balance, last transaction time and last name order.
+	 *
+	 * Each account is indexed under a (key, handle) pair, so equal keys stay distinct and
+	 * an entry can be found again from the key it was indexed under. The balance index is
+	 * an order-statistic tree, so it also answers top-N, bottom-N and rank queries. Those keys are kept
+	 * per handle, which lets an update move an entry in O(log n) without trusting the
+	 * account's current state to say where the old entry is.
+	 *
+	 * Each account also has an upper bound on the withdrawals in its history, so a
+	 * withdrawal filter can skip accounts without reading their histories. The bound is
+	 * unknown until the history has been read once, and only grows with transactions.
+	 *
+	 * Not thread-safe; Storage serializes access.
+	 */
+	class QueryIndex {
+	public:
+		/// Position of an account in Storage, the same value as Storage::AccountHandle
+		using Handle = std::size_t;
+
+		/// Last transaction time of an account with no transactions
+		static constexpr std::int64_t noActivity = std::numeric_limits<std::int64_t>::min();
+
+		/// Withdrawal bound of an account whose history has not been read yet
+		static constexpr double unknownWithdrawal = std::numeric_limits<double>::infinity();
+
+	private:
+		OrderStatisticTree byBalance;                               ///< Accounts ordered by balance, node id = handle
+		std::set<std::pair<std::int64_t, Handle>> byLastActivity;   ///< Accounts ordered by last transaction time
+		std::vector<double> balances;                               ///< Balance each account is indexed under
+		std::vector<std::int64_t> lastActivity;                     ///< Last transaction time each account is indexed under
+		std::vector<double> largestWithdrawal;                      ///< At least the largest withdrawal in each account's history
+		std::vector<std::uint64_t> updateCounts;                    ///< Updates of each account, to tell whether a bound read from its history is current
+		std::map<std::string_view, NameTable::NameId> lastNames;    ///< Interned last names in alphabetical order
+
+	public:
+		/**
+		 * @brief Forgets every account and last name.
+		 */
+		void clear();
+
+		/**
+		 * @brief Replaces every account entry in one pass.
+		 *
+		 * Sorts the keys and builds both indexes from sorted input, which is linear
+		 * rather than one O(log n) insertion per account. Last names are kept.
+		 *
+		 * @param accountBalances Balance of every account, by handle.
+		 * @param accountActivity Last transaction time of every account, by handle.
+		 * @param accountWithdrawals Withdrawal bound of every account, by handle, or unknownWithdrawal.
+		 */
+		void rebuild(std::vector<double> accountBalances, std::vector<std::int64_t> accountActivity,
+			std::vector<double> accountWithdrawals);
+
+		/**
+		 * @brief Indexes the account stored right after the last indexed one.
+		 *
+		 * @param handle Handle of the account; must equal the number of indexed accounts.
+		 * @param balance Current balance.
+		 * @param activity Last transaction time, or noActivity.
+		 * @param withdrawal Withdrawal bound, or unknownWithdrawal.
+		 */
+		void add(Handle handle, double balance, std::int64_t activity, double withdrawal);
+
+		/**
+		 * @brief Moves an account to its new balance and last transaction time.
+		 *
+		 * @param handle Handle of an indexed account.
+		 * @param balance Current balance.
+		 * @param activity Last transaction time.
+		 * @param withdrawn Amount withdrawn by the transaction, or 0 for a deposit.
+		 */
+		void update(Handle handle, double balance, std::int64_t activity, double withdrawn);
+
+		/**
+		 * @brief Narrows an account's withdrawal bound to what its history was found to hold.
+		 *
+		 * Ignored if the account was updated since updateCount was read, since the history
+		 * read may have missed that transaction.
+		 *
+		 * @param handle Handle of an indexed account.
+		 * @param withdrawal Largest withdrawal in the history.
+		 * @param updateCount getUpdateCount before the history was read.
+		 */
+		void narrowWithdrawal(Handle handle, double withdrawal, std::uint64_t updateCount);
+
+		/**
+		 * @brief Adds a newly interned last name to the alphabetical order.
+		 *
+		 * @param name View of the interned name; must stay valid while indexed.
+		 * @param id Interned id of the name.
+		 */
+		void addLastName(std::string_view name, NameTable::NameId id);
+
+		/**
+		 * @brief Gets the number of indexed accounts.
+		 * @return Account count.
+		 */
+		std::size_t size() const;
+
+		/**
+		 * @brief Gets the balance an account is indexed under.
+		 * @param handle Handle of an indexed account.
+		 * @return Indexed balance.
+		 */
+		double getBalance(Handle handle) const;
+
+		/**
+		 * @brief Gets the last transaction time an account is indexed under.
+		 * @param handle Handle of an indexed account.
+		 * @return Indexed time, or noActivity.
+		 */
+		std::int64_t getLastActivity(Handle handle) const;
+
+		/**
+		 * @brief Gets the upper bound on the withdrawals in an account's history.
+		 * @param handle Handle of an indexed account.
+		 * @return Bound, or unknownWithdrawal.
+		 */
+		double getLargestWithdrawal(Handle handle) const;
+
+		/**
+		 * @brief Gets the number of times an account was updated.
+		 * @param handle Handle of an indexed account.
+		 * @return Update count, for narrowWithdrawal.
+		 */
+		std::uint64_t getUpdateCount(Handle handle) const;
+
+		/**
+		 * @brief Counts accounts with a balance in a range in O(log n).
+		 *
+		 * @param minBalance Lowest balance, inclusive.
+		 * @param maxBalance Highest balance, inclusive.
+		 * @return Number of accounts in the range.
+		 */
+		std::size_t countBalanceRange(double minBalance, double maxBalance) const;
+
+		/**
+		 * @brief Gets an account's position when ordered from the largest balance down.
+		 * @param handle Handle of an indexed account.
+		 * @return 1 for the largest balance; equal balances are ranked by handle.
+		 */
+		std::size_t balanceRank(Handle handle) const;
+
+		/**
+		 * @brief Gets the accounts with the largest balances.
+		 * @param count Most accounts to return.
+		 * @return Handles, largest balance first.
+		 */
+		std::vector<Handle> largestBalances(std::size_t count) const;
+
+		/**
+		 * @brief Gets the accounts with the smallest balances.
+		 * @param count Most accounts to return.
+		 * @return Handles, smallest balance first.
+		 */
+		std::vector<Handle> smallestBalances(std::size_t count) const;
+
+		/**
+		 * @brief Counts accounts with a transaction at or after a time, stopping at a cap.
+		 *
+		 * @param since Earliest last transaction time.
+		 * @param cap Count at which to stop walking.
+		 * @return Number of such accounts, or cap if there are at least that many.
+		 */
+		std::size_t countActiveSince(std::int64_t since, std::size_t cap) const;
+
+		/**
+		 * @brief Visits accounts with a balance in a range, lowest first.
+		 *
+		 * @param minBalance Lowest balance, inclusive.
+		 * @param maxBalance Highest balance, inclusive.
+		 * @param visit Called with each handle; returning false stops the walk.
+		 */
+		template <typename Visit>
+		void forBalanceRange(double minBalance, double maxBalance, Visit visit) const {
+			byBalance.forEachFrom(byBalance.countBelow(minBalance, false), [&](OrderStatisticTree::Id id) {
+				return byBalance.keyOf(id) <= maxBalance && visit(static_cast<Handle>(id));
+			});
+		}
+
+		/**
+		 * @brief Visits accounts with a transaction at or after a time, oldest activity first.
+		 *
+		 * @param since Earliest last transaction time.
+		 * @param visit Called with each handle; returning false stops the walk.
+		 */
+		template <typename Visit>
+		void forActiveSince(std::int64_t since, Visit visit) const {
+			for (auto it = byLastActivity.lower_bound(std::make_pair(since, Handle(0))); it != byLastActivity.end(); ++it) {
+				if (!visit(it->second)) {
+					return;
+				}
+			}
+		}
+
+		/**
+		 * @brief Visits the interned last names that start with a prefix, in alphabetical order.
+		 *
+		 * @param prefix Start of the name.
+		 * @param visit Called with each name id; returning false stops the walk.
+		 */
+		template <typename Visit>
+		void forLastNamePrefix(std::string_view prefix, Visit visit) const {
+			for (auto it = lastNames.lower_bound(prefix);
+				it != lastNames.end() && it->first.substr(0, prefix.size()) == prefix; ++it) {
+				if (!visit(it->second)) {
+					return;
+				}
+			}
+		}
+	};
+}
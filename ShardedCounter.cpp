@@ -0,0 +1,151 @@
+#include "ShardedCounter.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace bankSimulation {
+
+    /**
+     * @brief Gets the shard owned by the calling thread.
+     *
+     * Threads are assigned shards round-robin the first time they touch any counter,
+     * so up to shardCount threads never share one.
+     *
+     * @return Index of the thread's shard.
+     */
+    std::size_t ShardedCounter::threadShard() {
+        static std::atomic<std::size_t> nextShard{ 0 };
+        thread_local std::size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % shardCount;
+        return shard;
+    }
+
+    /**
+     * @brief Creates a counter holding the given total.
+     * @param initial Starting value, kept in the first shard.
+     */
+    ShardedCounter::ShardedCounter(std::int64_t initial) {
+        shards[0].value.store(initial, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Copies the folded total of another counter.
+     * @param other Counter to copy.
+     */
+    ShardedCounter::ShardedCounter(const ShardedCounter& other) : ShardedCounter(other.load()) {}
+
+    /**
+     * @brief Copies the folded total of another counter.
+     * @param other Counter to copy.
+     * @return Reference to this counter.
+     */
+    ShardedCounter& ShardedCounter::operator=(const ShardedCounter& other) {
+        store(other.load());
+        return *this;
+    }
+
+    /**
+     * @brief Adds to the calling thread's shard.
+     *
+     * Only atomicity is needed, not ordering: totals are read after the writers have
+     * been joined or under the same locks that serialise their transactions.
+     *
+     * @param delta Amount to add; may be negative.
+     */
+    void ShardedCounter::add(std::int64_t delta) {
+        shards[threadShard()].value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Folds every shard into the current total.
+     * @return Sum of all shards.
+     */
+    std::int64_t ShardedCounter::load() const {
+        std::int64_t total = 0;
+        for (const auto& shard : shards) {
+            total += shard.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    /**
+     * @brief Replaces the total, keeping it in the first shard.
+     * @param value New total.
+     */
+    void ShardedCounter::store(std::int64_t value) {
+        shards[0].value.store(value, std::memory_order_relaxed);
+        for (std::size_t i = 1; i < shardCount; ++i) {
+            shards[i].value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    namespace {
+        /**
+         * @brief Runs the same body on several threads and times the whole run.
+         *
+         * @param threadCount Number of threads.
+         * @param body Work for one thread.
+         * @return Elapsed seconds.
+         */
+        template <typename Body>
+        double timeThreads(unsigned threadCount, Body body) {
+            std::vector<std::thread> workers;
+            auto start = std::chrono::steady_clock::now();
+            for (unsigned t = 0; t < threadCount; ++t) {
+                workers.emplace_back(body);
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    /**
+     * @brief Compares ShardedCounter against a single shared atomic as threads are added.
+     *
+     * The baseline keeps deposits and holdings as two adjacent atomics, which is how
+     * BankFunds stored its totals before sharding.
+     *
+     * @param maxThreads Largest thread count to measure.
+     * @param operationsPerThread Operations each thread performs per run.
+     */
+    void runCounterBenchmark(unsigned maxThreads, std::size_t operationsPerThread) {
+        std::cout << "--- Counter Benchmark ---" << std::endl;
+        std::cout << "threads,single_atomic_mops,sharded_mops,speedup" << std::endl;
+
+        for (unsigned threads = 1; threads <= maxThreads; threads *= 2) {
+            double totalOperations = static_cast<double>(threads) * operationsPerThread;
+
+            struct {
+                std::atomic<std::int64_t> deposits{ 0 };
+                std::atomic<std::int64_t> holdings{ 0 };
+            } single;
+            double singleSeconds = timeThreads(threads, [&single, operationsPerThread]() {
+                for (std::size_t i = 0; i < operationsPerThread; ++i) {
+                    single.deposits.fetch_add(1, std::memory_order_relaxed);
+                    single.holdings.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+
+            ShardedCounter deposits, holdings;
+            double shardedSeconds = timeThreads(threads, [&deposits, &holdings, operationsPerThread]() {
+                for (std::size_t i = 0; i < operationsPerThread; ++i) {
+                    deposits.add(1);
+                    holdings.add(1);
+                }
+            });
+
+            if (single.deposits.load() != deposits.load() || single.holdings.load() != holdings.load()) {
+                std::cerr << "Counter totals disagree at " << threads << " threads." << std::endl;
+            }
+
+            double singleRate = totalOperations / singleSeconds / 1e6;
+            double shardedRate = totalOperations / shardedSeconds / 1e6;
+            std::cout << threads << std::fixed << std::setprecision(2)
+                << "," << singleRate << "," << shardedRate << "," << shardedRate / singleRate << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace bankSimulation {
+
+	/**
+	 * @class ShardedCounter
+	 * @brief A 64-bit running total split across per-thread, cache-line-padded shards.
+	 *
+	 * Each thread adds into its own shard, so concurrent updates never fight over one
+	 * cache line. Reading folds the shards together; a read taken while other threads
+	 * are adding sees some prefix of their updates, exactly like a single atomic would.
+	 */
+	class ShardedCounter {
+	public:
+		/// Number of shards; threads beyond this share shards round-robin
+		static const std::size_t shardCount = 16;
+
+	private:
+		/**
+		 * @struct Shard
+		 * @brief One partial total padded out to a full cache line.
+		 *
+		 * Padding rather than alignas keeps shards on separate lines even when the
+		 * counter lives in a std::vector, which does not honour over-alignment before C++17.
+		 */
+		struct Shard {
+			std::atomic<std::int64_t> value{ 0 };
+			char padding[64 - sizeof(std::atomic<std::int64_t>)];
+		};
+
+		Shard shards[shardCount];     ///< Partial totals, one per group of threads
+
+		/**
+		 * @brief Gets the shard owned by the calling thread.
+		 * @return Index of the thread's shard.
+		 */
+		static std::size_t threadShard();
+
+	public:
+		/**
+		 * @brief Creates a counter holding the given total.
+		 * @param initial Starting value.
+		 */
+		explicit ShardedCounter(std::int64_t initial = 0);
+
+		/**
+		 * @brief Copies the folded total of another counter.
+		 * @param other Counter to copy.
+		 */
+		ShardedCounter(const ShardedCounter& other);
+
+		/**
+		 * @brief Copies the folded total of another counter.
+		 * @param other Counter to copy.
+		 * @return Reference to this counter.
+		 */
+		ShardedCounter& operator=(const ShardedCounter& other);
+
+		/**
+		 * @brief Adds to the calling thread's shard. Safe to call from any thread.
+		 * @param delta Amount to add; may be negative.
+		 */
+		void add(std::int64_t delta);
+
+		/**
+		 * @brief Folds every shard into the current total.
+		 * @return Sum of all shards.
+		 */
+		std::int64_t load() const;
+
+		/**
+		 * @brief Replaces the total. Must not race with add().
+		 * @param value New total.
+		 */
+		void store(std::int64_t value);
+	};
+
+	/**
+	 * @brief Compares ShardedCounter against a single shared atomic as threads are added.
+	 *
+	 * Both variants apply the same deposit pattern (one add to deposits and one to
+	 * holdings per operation). Thread counts double from 1 up to the given maximum.
+	 *
+	 * @param maxThreads Largest thread count to measure.
+	 * @param operationsPerThread Operations each thread performs per run.
+	 */
+	void runCounterBenchmark(unsigned maxThreads, std::size_t operationsPerThread);
+}
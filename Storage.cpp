@@ -1,7 +1,190 @@
 #include "Storage.h"
+#include "AccountFileFormat.h"
+#include "AccountFileUpdater.h"
+#include "AccountFileWriter.h"
+#include "DurableFile.h"
+#include "MappedFile.h"
+#include "Metrics.h"
+#include "Trace.h"
 #include "Validators.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <thread>
 
 namespace bankSimulation {
+    namespace {
+        /// Accounts a load thread reads from accounts.dat before claiming the next chunk
+        const std::size_t loadChunkAccounts = 16'384;
+
+        /**
+         * @brief Checks that a range lies inside the accounts.dat heap.
+         * @param heapSize Mapped length of the heap.
+         * @param offset Start of the range.
+         * @param length Length of the range.
+         * @return True if the whole range is mapped.
+         */
+        bool inHeap(std::uint64_t heapSize, std::uint64_t offset, std::uint64_t length) {
+            return offset <= heapSize && length <= heapSize - offset;
+        }
+
+        /**
+         * @brief Copies a heap string out of accounts.dat.
+         * @param heap Start of the mapped heap.
+         * @param ref Location of the string.
+         * @return The string.
+         */
+        std::string heapText(const char* heap, const accountFile::HeapString& ref) {
+            return std::string(heap + ref.offset, ref.length);
+        }
+
+        /**
+         * @brief Reads one stored transaction out of the accounts.dat heap.
+         *
+         * Version 3 and later records are copied as they are; version 2 records have their type
+         * and timestamp strings parsed.
+         *
+         * @param heap Start of the mapped heap.
+         * @param heapSize Mapped length of the heap.
+         * @param version Layout version of the file.
+         * @param offset Heap offset of the history record, already checked to be mapped.
+         * @param t Transaction to fill in.
+         * @return False if a version 2 record points outside the heap.
+         */
+        bool readHeapTransaction(const char* heap, std::uint64_t heapSize, std::uint32_t version,
+            std::uint64_t offset, Account::Transaction& t) {
+            if (version == 2) {
+                accountFile::HistoryRecordV2 record;
+                std::memcpy(&record, heap + offset, sizeof(record));
+                if (!inHeap(heapSize, record.type.offset, record.type.length)
+                    || !inHeap(heapSize, record.timestamp.offset, record.timestamp.length)) {
+                    return false;
+                }
+
+                t.timestamp = Account::parseTimestamp(heapText(heap, record.timestamp));
+                t.amount = record.amount;
+                t.resultingBalance = record.resultingBalance;
+                t.type = Account::parseTypeName(heapText(heap, record.type));
+            }
+            else {
+                accountFile::HistoryRecord record;
+                std::memcpy(&record, heap + offset, sizeof(record));
+                t.timestamp = record.timestamp;
+                t.amount = record.amount;
+                t.resultingBalance = record.resultingBalance;
+                t.type = static_cast<Account::TransactionType>(record.type);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Builds a transaction history from its heap block.
+         *
+         * Stops at the first version 2 entry that points outside the heap.
+         *
+         * @param heap Start of the mapped heap.
+         * @param heapSize Mapped length of the heap.
+         * @param version Layout version of the file.
+         * @param offset Heap offset of the first history record.
+         * @param count Number of stored transactions.
+         * @param resource Memory resource of the account the history is for.
+         * @return Transactions in chronological order.
+         */
+        /**
+         * @brief Finds the largest withdrawal in a loaded history.
+         * @param account Account whose history is loaded.
+         * @return Largest withdrawn amount, or 0 if there is none.
+         */
+        double largestWithdrawalIn(const Account& account) {
+            double largest = 0.0;
+            for (int i = 0; i < account.getTransactionCount(); ++i) {
+                const Account::Transaction& t = account.getTransaction(i);
+                if (t.type == Account::TransactionType::Withdrawal) {
+                    largest = std::max(largest, t.amount);
+                }
+            }
+            return largest;
+        }
+
+        Account::History readHeapHistory(const char* heap, std::uint64_t heapSize,
+            std::uint32_t version, std::uint64_t offset, int count, std::pmr::memory_resource* resource) {
+            Account::History history(resource);
+            std::uint64_t recordSize = accountFile::historyRecordSize(version);
+            if (!inHeap(heapSize, offset, static_cast<std::uint64_t>(count) * recordSize)) {
+                return history;
+            }
+
+            history.reserve(static_cast<std::size_t>(count));
+            for (int h = 0; h < count; ++h) {
+                Account::Transaction t;
+                if (!readHeapTransaction(heap, heapSize, version, offset + h * recordSize, t)) {
+                    break;
+                }
+                history.push_back(t);
+            }
+            return history;
+        }
+    }
+
+    const Storage::AccountHandle Storage::noAccount;
+
+    /**
+     * @struct Storage::Snapshot
+     * @brief State copied by a background checkpoint while transactions were held off.
+     */
+    struct Storage::Snapshot {
+        std::uint64_t sequence = 0;              ///< Last journal record the copies include
+        std::vector<AccountHandle> handles;      ///< Captured accounts, ascending
+        std::vector<Account> accounts;           ///< Copies of the captured accounts, in the order of handles
+        std::vector<BankFunds> funds;            ///< Copies of the fund records
+        std::uint64_t accountCount = 0;          ///< Accounts stored at the capture
+        unsigned lastAccountNumber = 0;          ///< Next account number at the capture
+        bool sealed = false;                     ///< Whether the journal up to sequence was sealed
+    };
+
+    /**
+     * @brief Creates an empty storage whose data files live in the given directory.
+     *
+     * Nothing is read until loadBank and loadAccount are called.
+     *
+     * @param directory Existing directory for the data files; empty for the working directory.
+     */
+    Storage::Storage(const std::string& directory)
+        : dataDirectory(directory), journal(dataPath("journal.dat")) {}
+
+    /**
+     * @brief Builds the path of a data file inside the data directory.
+     * @param fileName Name of the data file.
+     * @return Path to open.
+     */
+    std::string Storage::dataPath(const char* fileName) const {
+        if (dataDirectory.empty()) {
+            return fileName;
+        }
+
+        char last = dataDirectory.back();
+        return (last == '/' || last == '\\') ? dataDirectory + fileName : dataDirectory + "/" + fileName;
+    }
+
+    /**
+     * @brief Chooses where new account histories are allocated.
+     *
+     * Eagerly loaded histories live as long as the book, so they come from the arena.
+     * Lazy mode pages histories in and out, which a monotonic arena could never reclaim,
+     * so those stay on the heap.
+     *
+     * @return Resource to create accounts with.
+     */
+    std::pmr::memory_resource* Storage::historyResource() {
+        return lazyHistory ? std::pmr::new_delete_resource() : &accountArena;
+    }
+
     /**
      * @brief Returns a reference to the vector containing all Account objects.
      *
@@ -22,15 +205,207 @@ namespace bankSimulation {
         return funds; 
     }
 
+    /**
+     * @brief Returns the account a handle refers to.
+     * @param handle Handle returned by a lookup.
+     * @return Reference to the account.
+     */
+    Account& Storage::getAccount(AccountHandle handle) {
+        return accounts[handle];
+    }
+
+    /**
+     * @brief Returns the account a handle refers to.
+     * @param handle Handle returned by a lookup.
+     * @return Const reference to the account.
+     */
+    const Account& Storage::getAccount(AccountHandle handle) const {
+        return accounts[handle];
+    }
+
+    /**
+     * @brief Looks up an account number in the hash index.
+     * @param accountNumber Account number to look up.
+     * @return Handle of the account, or noAccount if none matches.
+     */
+    Storage::AccountHandle Storage::findByAccountNumber(unsigned accountNumber) const {
+        auto it = accountNumberIndex.find(accountNumber);
+        return it == accountNumberIndex.end() ? noAccount : it->second;
+    }
+
+    /**
+     * @brief Resolves a last name to its interned id.
+     *
+     * Hashes the view directly, so a query needs no string copy. Every later
+     * comparison is on the id.
+     *
+     * @param lastName Last name to look up.
+     * @return Id of the name, or NameTable::noName if no account has it.
+     */
+    NameTable::NameId Storage::findLastNameId(std::string_view lastName) const {
+        return lastNames.find(lastName);
+    }
+
+    /**
+     * @brief Gets the handles of every account with an interned last name.
+     * @param lastNameId Id returned by findLastNameId.
+     * @return Handles of every matching account in creation order.
+     */
+    const Storage::HandleList& Storage::findByLastName(NameTable::NameId lastNameId) const {
+        static const HandleList noMatches;
+        return lastNameId < lastNameIndex.size() ? lastNameIndex[lastNameId] : noMatches;
+    }
+
+    /**
+     * @brief Stores a new account and indexes it.
+     *
+     * Holds the transaction lock, since growing the container would pull it out from
+     * under a background capture. While checkpoints run in the background, the new
+     * account is queued for the next one.
+     *
+     * @param account Fully initialized account.
+     * @return Handle of the stored account.
+     */
+    Storage::AccountHandle Storage::addAccount(Account&& account) {
+        std::shared_lock<std::shared_mutex> state(stateMutex);
+        accounts.push_back(std::move(account));
+        AccountHandle handle = accounts.size() - 1;
+        indexAccount(handle);
+
+        std::lock_guard<std::mutex> lock(queryIndexMutex);
+        std::int64_t activity = lastActivityOf(accounts[handle]);
+        queryIndex.add(handle, accounts[handle].getBalance(), activity,
+            activity == QueryIndex::noActivity ? 0.0 : QueryIndex::unknownWithdrawal);
+        if (checkpointer.isRunning() && !batchActive) {
+            changedAccounts.push_back(handle);
+        }
+        return handle;
+    }
+
+    /**
+     * @brief Adds one account to the account number and last name indexes.
+     *
+     * Interns the last name and gives the account its id. Ids are dense, so a name
+     * seen for the first time always gets the next free slot of the name index.
+     *
+     * @param handle Handle of the account to index.
+     */
+    void Storage::indexAccount(AccountHandle handle) {
+        Account& acc = accounts[handle];
+        accountNumberIndex[acc.getHolderAccountNumber()] = handle;
+
+        NameTable::NameId lastNameId = lastNames.intern(acc.getHolderLastName());
+        acc.setLastNameId(lastNameId);
+        if (lastNameId == lastNameIndex.size()) {
+            lastNameIndex.emplace_back();
+            queryIndex.addLastName(lastNames.get(lastNameId), lastNameId);
+        }
+        lastNameIndex[lastNameId].push_back(handle);
+    }
+
+    /**
+     * @brief Clears and repopulates both indexes from the accounts container.
+     */
+    void Storage::rebuildIndexes() {
+        TraceScope trace("rebuildIndexes", "startup");
+        accountNumberIndex.clear();
+        lastNameIndex.clear();
+        lastNames.clear();
+        queryIndex.clear();
+        accountNumberIndex.reserve(accounts.size());
+        for (AccountHandle handle = 0; handle < accounts.size(); ++handle) {
+            indexAccount(handle);
+        }
+    }
+
+    /**
+     * @brief Rebuilds the balance, last transaction time and withdrawal indexes in one pass.
+     *
+     * Runs after the journal tail has been replayed, so the indexes start from the
+     * final balances rather than being updated once per replayed record. The withdrawal
+     * bound of a history that was not loaded is left unknown, so lazy mode still reads
+     * only the newest record of each.
+     */
+    void Storage::rebuildQueryIndex() {
+        TraceScope trace("rebuildQueryIndex", "startup");
+        std::vector<double> balances;
+        std::vector<std::int64_t> activity;
+        std::vector<double> withdrawals;
+        balances.reserve(accounts.size());
+        activity.reserve(accounts.size());
+        withdrawals.reserve(accounts.size());
+        for (const auto& acc : accounts) {
+            balances.push_back(acc.getBalance());
+            activity.push_back(lastActivityOf(acc));
+            withdrawals.push_back(acc.getTransactionCount() == 0 ? 0.0
+                : acc.isHistoryLoaded() ? largestWithdrawalIn(acc) : QueryIndex::unknownWithdrawal);
+        }
+
+        std::lock_guard<std::mutex> lock(queryIndexMutex);
+        queryIndex.rebuild(std::move(balances), std::move(activity), std::move(withdrawals));
+    }
+
+    /**
+     * @brief Gets the time of an account's newest transaction.
+     *
+     * A history that is not loaded is not paged in; only its newest record is read
+     * from the mapped accounts.dat. A background checkpoint remaps that file, so the
+     * caller holds stateMutex (shared is enough) or runs before the checkpointer starts.
+     *
+     * @param account Account stored in this Storage.
+     * @return Seconds since the epoch, or QueryIndex::noActivity if it has no transactions.
+     */
+    std::int64_t Storage::lastActivityOf(const Account& account) const {
+        int count = account.getTransactionCount();
+        if (count == 0) {
+            return QueryIndex::noActivity;
+        }
+        if (account.isHistoryLoaded()) {
+            return account.getTransaction(count - 1).timestamp;
+        }
+        if (!accountsFile.isOpen() || accountsHeapOffset > accountsFile.getSize()) {
+            return QueryIndex::noActivity;
+        }
+
+        const char* heap = accountsFile.getData() + accountsHeapOffset;
+        std::uint64_t heapSize = accountsFile.getSize() - accountsHeapOffset;
+        std::uint64_t recordSize = accountFile::historyRecordSize(accountsVersion);
+        std::uint64_t offset = account.getHistoryOffset() + static_cast<std::uint64_t>(count - 1) * recordSize;
+
+        Account::Transaction newest;
+        if (!inHeap(heapSize, offset, recordSize) || !readHeapTransaction(heap, heapSize, accountsVersion, offset, newest)) {
+            return QueryIndex::noActivity;
+        }
+        return newest.timestamp;
+    }
+
+    /**
+     * @brief Gets the handle of an account from its address.
+     *
+     * Accounts outside the container, such as ones a benchmark keeps on its own,
+     * have no handle.
+     *
+     * @param account Account to look up.
+     * @return Handle, or noAccount.
+     */
+    Storage::AccountHandle Storage::handleOf(const Account& account) const {
+        std::less<const Account*> before;
+        if (accounts.empty() || before(&account, accounts.data()) || !before(&account, accounts.data() + accounts.size())) {
+            return noAccount;
+        }
+        return static_cast<AccountHandle>(&account - accounts.data());
+    }
+
     /**
      * @brief Creates a new Account object from validated user input and adds it to storage.
      *
      * Prompts user for first and last name, enforces password strength requirements,
      * confirms input with the user, assigns a unique account number, initializes balance,
-     * then stores the new account.
+     * then stores the new account. Account creation is rare, so it checkpoints right
+     * away instead of journaling the new account.
      */
     void Storage::newAccount() {
-        Account account; 
+        Account account(historyResource());
 
         std::cout << "Welcome to your new account. Let's start by getting some basic information about you." << std::endl;
 
@@ -57,16 +432,17 @@ namespace bankSimulation {
         account.setHolderAccountNumber(lastAccountNumber++); 
         account.setBalance(0.0);  
 
-        accounts.push_back(account);
+        addAccount(std::move(account));
+        checkpoint();
     }
 
     /**
      * @brief Searches stored accounts by account number or last name and displays results.
      *
-     * Allows the user to select search criteria, performs search on accounts vector,
-     * and prints account balances and transaction histories for any matches found.
+     * Allows the user to select search criteria, looks the query up in the matching
+     * index, and prints account balances and transaction histories for any matches found.
      */
-    void Storage::searchAccounts() const {
+    void Storage::searchAccounts() {
         if (accounts.empty()) {
             std::cout << "No accounts found." << std::endl;
             return;
@@ -84,14 +460,14 @@ namespace bankSimulation {
         case '1': {
             unsigned searchNumber = bankSimulation::numericValidator("Enter the account number: ", 1, 999999999);
 
-            for (const auto& acc : accounts) {
-                if (acc.getHolderAccountNumber() == searchNumber) {
-                    std::cout << std::endl << "Account found:" << std::endl;
-                    acc.printAccountBalance();
-                    acc.printAccountHistory();
-                    found = true;
-                    break;
-                }
+            AccountHandle handle = findByAccountNumber(searchNumber);
+            if (handle != noAccount) {
+                Account& acc = getAccount(handle);
+                loadHistory(acc);
+                std::cout << std::endl << "Account found:" << std::endl;
+                acc.printAccountBalance();
+                acc.printAccountHistory();
+                found = true;
             }
 
             if (!found) {
@@ -101,13 +477,13 @@ namespace bankSimulation {
         }
         case '2': {
             std::string searchLastName = bankSimulation::stringValidator("Enter the account holder's last name: ");
-            for (const auto& acc : accounts) {
-                if (acc.getHolderLastName() == searchLastName) {
-                    std::cout << std::endl << "nAccount found:" << std::endl;
-                    acc.printAccountBalance();
-                    acc.printAccountHistory();
-                    found = true;
-                }
+            for (AccountHandle handle : findByLastName(findLastNameId(searchLastName))) {
+                Account& acc = getAccount(handle);
+                loadHistory(acc);
+                std::cout << std::endl << "nAccount found:" << std::endl;
+                acc.printAccountBalance();
+                acc.printAccountHistory();
+                found = true;
             }
 
             if (!found) {
@@ -123,147 +499,1454 @@ namespace bankSimulation {
     }
 
     /**
-     * @brief Serializes and writes all Account objects and last account number to a binary file.
+     * @brief Finds accounts that pass every filter of a query.
+     *
+     * Each filter can drive the walk through its own index: last name order for a
+     * name prefix, last transaction time for an activity or withdrawal filter (an
+     * account without transactions cannot match either), and balance for a balance
+     * range. With no such filter every account is walked. When several apply, each
+     * index is counted up to the smallest count found so far and the smallest one is
+     * walked, so choosing never costs more than the walk itself.
      *
-     * Opens "accounts.dat" for binary output, writes account count, serializes each account,
-     * and saves the last assigned account number for data continuity.
+     * Cheap filters are checked against the indexed values under the index lock, and
+     * the walk stops as soon as the limit is reached. The withdrawal filter first skips
+     * accounts whose indexed withdrawal bound is too small. The rest need their
+     * histories read, so that runs afterwards, without the index lock, on at most
+     * query.historyScanLimit accounts. Reading a history narrows its bound, so repeated
+     * queries read fewer histories and reach accounts past the limit of earlier ones.
+     *
+     * @param query Filters and result limit.
+     * @return Handles of matching accounts.
      */
-    void Storage::saveAccount() {
-        std::ofstream out("accounts.dat", std::ios::binary);
+    std::vector<Storage::AccountHandle> Storage::findAccounts(const AccountQuery& query) {
+        double minBalance = query.minBalance.value_or(-std::numeric_limits<double>::infinity());
+        double maxBalance = query.maxBalance.value_or(std::numeric_limits<double>::infinity());
+        std::int64_t since = query.activeSince.value_or(QueryIndex::noActivity + 1);
+        std::string_view prefix = query.lastNamePrefix;
+        bool checksHistory = query.withdrawalOver.has_value();
 
-        if (!out) {
-            std::cerr << "Error opening accounts.dat for writing." << std::endl;
-            return;
-        }
+        // Each candidate with its index update count, for narrowing its withdrawal bound
+        std::vector<std::pair<AccountHandle, std::uint64_t>> candidates;
+        {
+            std::lock_guard<std::mutex> lock(queryIndexMutex);
 
-        size_t count = accounts.size();
-        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+            // Returns false once enough accounts have been found, or enough histories to read
+            auto consider = [&](AccountHandle handle) {
+                double balance = queryIndex.getBalance(handle);
+                if (balance < minBalance || balance > maxBalance
+                    || ((query.activeSince || checksHistory) && queryIndex.getLastActivity(handle) < since)
+                    || (checksHistory && queryIndex.getLargestWithdrawal(handle) <= *query.withdrawalOver)
+                    || accounts[handle].getHolderLastName().substr(0, prefix.size()) != prefix) {
+                    return true;
+                }
+                candidates.emplace_back(handle, queryIndex.getUpdateCount(handle));
+                return candidates.size() < (checksHistory ? query.historyScanLimit : query.limit);
+            };
 
-        for (const auto& acc : accounts) {
-            acc.serialize(out);
+            enum class Walk { AllAccounts, LastName, Activity, Balance };
+            bool byLastName = !prefix.empty();
+            bool byActivity = query.activeSince || checksHistory;
+            bool byBalance = query.minBalance || query.maxBalance;
+
+            Walk walk = byLastName ? Walk::LastName : byActivity ? Walk::Activity : byBalance ? Walk::Balance : Walk::AllAccounts;
+            if (byLastName + byActivity + byBalance > 1) {
+                std::size_t fewest = queryIndex.size();
+                if (byLastName) {
+                    std::size_t count = 0;
+                    queryIndex.forLastNamePrefix(prefix, [&](NameTable::NameId lastNameId) {
+                        count += lastNameIndex[lastNameId].size();
+                        return count < fewest;
+                    });
+                    fewest = std::min(count, fewest);
+                }
+                if (byActivity) {
+                    std::size_t count = queryIndex.countActiveSince(since, fewest);
+                    if (count < fewest) {
+                        fewest = count;
+                        walk = Walk::Activity;
+                    }
+                }
+                if (byBalance && queryIndex.countBalanceRange(minBalance, maxBalance) < fewest) {
+                    walk = Walk::Balance;
+                }
+            }
+
+            if (walk == Walk::LastName) {
+                queryIndex.forLastNamePrefix(prefix, [&](NameTable::NameId lastNameId) {
+                    for (AccountHandle handle : lastNameIndex[lastNameId]) {
+                        if (!consider(handle)) {
+                            return false;
+                        }
+                    }
+                    return true;
+                });
+            }
+            else if (walk == Walk::Activity) {
+                queryIndex.forActiveSince(since, consider);
+            }
+            else if (walk == Walk::Balance) {
+                queryIndex.forBalanceRange(minBalance, maxBalance, consider);
+            }
+            else {
+                for (AccountHandle handle = 0; handle < queryIndex.size(); ++handle) {
+                    if (!consider(handle)) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        std::vector<AccountHandle> matches;
+        if (!checksHistory) {
+            for (std::size_t i = 0; i < candidates.size() && i < query.limit; ++i) {
+                matches.push_back(candidates[i].first);
+            }
+            return matches;
         }
 
-        out.write(reinterpret_cast<const char*>(&lastAccountNumber), sizeof(lastAccountNumber));
+        // Every withdrawal is read, not only the recent ones, so the bound can be narrowed.
+        // A history that is not resident is read for this alone rather than paged in, so a
+        // query never evicts the working set; historyMutex keeps it resident, and
+        // accounts.dat mapped, while it is read.
+        for (const auto& [handle, updateCount] : candidates) {
+            if (matches.size() >= query.limit) {
+                break;
+            }
+
+            const Account& acc = accounts[handle];
+            double largest = 0.0;
+            bool matched = false;
+            auto visit = [&](const Account::Transaction& t) {
+                if (t.type == Account::TransactionType::Withdrawal) {
+                    largest = std::max(largest, t.amount);
+                    matched = matched || (t.amount > *query.withdrawalOver && t.timestamp >= since);
+                }
+            };
+            {
+                std::lock_guard<std::mutex> lock(historyMutex);
+                if (acc.isHistoryLoaded()) {
+                    for (int i = 0; i < acc.getTransactionCount(); ++i) {
+                        visit(acc.getTransaction(i));
+                    }
+                }
+                else if (accountsFile.isOpen() && accountsHeapOffset <= accountsFile.getSize()) {
+                    Account::History stored = readHeapHistory(accountsFile.getData() + accountsHeapOffset,
+                        accountsFile.getSize() - accountsHeapOffset, accountsVersion, acc.getHistoryOffset(),
+                        acc.getTransactionCount(), std::pmr::new_delete_resource());
+                    for (const auto& t : stored) {
+                        visit(t);
+                    }
+                }
+            }
 
-        out.close();
+            if (matched) {
+                matches.push_back(handle);
+            }
+            std::lock_guard<std::mutex> lock(queryIndexMutex);
+            queryIndex.narrowWithdrawal(handle, largest, updateCount);
+        }
+        return matches;
     }
 
     /**
-     * @brief Reads and deserializes Account objects and last account number from binary file.
+     * @brief Builds a query from the employee's answers, runs it and prints the matches.
      *
-     * Attempts to open "accounts.dat", creates it with default values if missing,
-     * reads the number of accounts, deserializes each account into storage,
-     * and restores last assigned account number.
+     * Every filter is optional. Dates are entered as YYYY-MM-DD and mean midnight,
+     * local time.
      */
-    void Storage::loadAccount() {
-        std::ifstream in("accounts.dat", std::ios::binary);
+    void Storage::queryAccounts() {
+        AccountQuery query;
 
-        if (!in) {
-            std::cerr << "accounts.dat not found. Creating a new file." << std::endl;
+        std::cout << "Answer N to skip a filter." << std::endl;
+        if (charValidator("Filter by balance range? [Y / N]: ", { 'y', 'n' }) == 'y') {
+            query.minBalance = numericValidator("Lowest balance: ", 0.0, 1e12);
+            query.maxBalance = numericValidator("Highest balance: ", *query.minBalance, 1e12);
+        }
+        if (charValidator("Filter by last name prefix? [Y / N]: ", { 'y', 'n' }) == 'y') {
+            query.lastNamePrefix = stringValidator("Last name starts with: ");
+        }
+        if (charValidator("Only accounts with a transaction since a date? [Y / N]: ", { 'y', 'n' }) == 'y') {
+            std::int64_t since = 0;
+            while (since == 0) {
+                since = Account::parseTimestamp(stringValidator("Date (YYYY-MM-DD): ") + " 00:00:00");
+                if (since == 0) {
+                    std::cout << "Enter the date as YYYY-MM-DD." << std::endl;
+                }
+            }
+            query.activeSince = since;
+        }
+        if (charValidator("Only accounts with a withdrawal over an amount? [Y / N]: ", { 'y', 'n' }) == 'y') {
+            query.withdrawalOver = numericValidator("Withdrawal over: ", 0.0, Account::maxTransactionAmount);
+        }
+        query.limit = static_cast<std::size_t>(numericValidator("Most accounts to show: ", 1, 1'000));
 
-            std::ofstream out("accounts.dat", std::ios::binary);
-            if (!out) {
-                std::cerr << "Failed to create accounts.dat" << std::endl;
-                return;
+        auto start = std::chrono::steady_clock::now();
+        std::vector<AccountHandle> matches = findAccounts(query);
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // The index already holds each last transaction time; reading it from the mapped
+        // file here could race a background checkpoint remapping accounts.dat
+        std::vector<std::int64_t> activity;
+        {
+            std::lock_guard<std::mutex> lock(queryIndexMutex);
+            activity.reserve(matches.size());
+            for (AccountHandle handle : matches) {
+                activity.push_back(queryIndex.getLastActivity(handle));
             }
+        }
+
+        std::cout << std::endl << std::fixed << std::setprecision(2);
+        for (std::size_t i = 0; i < matches.size(); ++i) {
+            const Account& acc = accounts[matches[i]];
+            std::int64_t lastActivity = activity[i];
+            std::cout << "#" << acc.getHolderAccountNumber() << "  " << acc.getHolderLastName() << ", "
+                << acc.getHolderFirstName() << "  $" << acc.getBalance() << "  last transaction: "
+                << (lastActivity == QueryIndex::noActivity ? std::string("none") : Account::formatTimestamp(lastActivity))
+                << std::endl;
+        }
+        std::cout << matches.size() << (matches.size() == 1 ? " account" : " accounts") << " found in "
+            << milliseconds << " ms." << std::endl;
+    }
 
-            size_t count = 0;
-            out.write(reinterpret_cast<const char*>(&count), sizeof(count));
-            out.write(reinterpret_cast<const char*>(&lastAccountNumber), sizeof(lastAccountNumber));
-            out.close();
+    /**
+     * @brief Gets the accounts with the largest balances from the balance index.
+     * @param count Most accounts to return.
+     * @return Handles, largest balance first.
+     */
+    std::vector<Storage::AccountHandle> Storage::largestAccounts(std::size_t count) {
+        std::lock_guard<std::mutex> lock(queryIndexMutex);
+        return queryIndex.largestBalances(count);
+    }
+
+    /**
+     * @brief Gets the accounts with the smallest balances from the balance index.
+     * @param count Most accounts to return.
+     * @return Handles, smallest balance first.
+     */
+    std::vector<Storage::AccountHandle> Storage::smallestAccounts(std::size_t count) {
+        std::lock_guard<std::mutex> lock(queryIndexMutex);
+        return queryIndex.smallestBalances(count);
+    }
+
+    /**
+     * @brief Gets an account's place on the balance leaderboard.
+     * @param handle Handle of a stored account.
+     * @return 1 for the largest balance, or 0 if the handle is not indexed.
+     */
+    std::size_t Storage::balanceRank(AccountHandle handle) {
+        std::lock_guard<std::mutex> lock(queryIndexMutex);
+        return handle < queryIndex.size() ? queryIndex.balanceRank(handle) : 0;
+    }
+
+    /**
+     * @brief Prints the top or bottom of the balance leaderboard, or one account's rank.
+     *
+     * Prompts for the report to show, reads it from the balance index and prints
+     * the accounts with their places and balances.
+     */
+    void Storage::balanceLeaderboard() {
+        std::cout << "1. Largest balances" << std::endl;
+        std::cout << "2. Smallest balances" << std::endl;
+        std::cout << "3. Rank of an account" << std::endl;
+        int selection = numericValidator("Your selection: ", 1, 3);
 
-            in.open("accounts.dat", std::ios::binary);
-            if (!in) {
-                std::cerr << "Could not open accounts.dat after creation." << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        if (selection == 3) {
+            unsigned accountNumber = numericValidator("Enter the account number: ", 1, 999999999);
+            AccountHandle handle = findByAccountNumber(accountNumber);
+            std::size_t rank = handle == noAccount ? 0 : balanceRank(handle);
+            if (rank == 0) {
+                std::cout << "No account found with that number." << std::endl;
                 return;
             }
+            std::cout << "#" << accountNumber << " ranks " << rank << " of " << accounts.size()
+                << " by balance ($" << accounts[handle].getBalance() << ")." << std::endl;
+            return;
         }
 
-        size_t count;
-        in.read(reinterpret_cast<char*>(&count), sizeof(count));
-        accounts.clear();
+        std::size_t count = static_cast<std::size_t>(numericValidator("Accounts to show: ", 1, 1'000));
+        std::vector<AccountHandle> handles = selection == 1 ? largestAccounts(count) : smallestAccounts(count);
 
-        for (size_t i = 0; i < count; ++i) {
-            Account temp;
-            temp.deserialize(in);
-            accounts.push_back(temp);
+        std::cout << std::endl;
+        for (std::size_t i = 0; i < handles.size(); ++i) {
+            const Account& acc = accounts[handles[i]];
+            std::size_t place = selection == 1 ? i + 1 : accounts.size() - i;
+            std::cout << place << ". #" << acc.getHolderAccountNumber() << "  " << acc.getHolderLastName() << ", "
+                << acc.getHolderFirstName() << "  $" << acc.getBalance() << std::endl;
         }
+    }
 
-        in.read(reinterpret_cast<char*>(&lastAccountNumber), sizeof(lastAccountNumber));
+    /**
+     * @brief Re-keys an account in the query indexes after a transaction.
+     * @param account Account whose balance was just updated.
+     * @param lastTransaction Time of the transaction.
+     * @param withdrawn Amount withdrawn by the transaction, or 0 for a deposit.
+     */
+    void Storage::updateQueryIndex(const Account& account, std::time_t lastTransaction, double withdrawn) {
+        AccountHandle handle = handleOf(account);
+        if (handle == noAccount) {
+            return;
+        }
 
-        std::cout << "Successfully loaded account entries." << std::endl;
-        in.close();
+        std::lock_guard<std::mutex> lock(queryIndexMutex);
+        if (handle < queryIndex.size()) {
+            queryIndex.update(handle, account.getBalance(), static_cast<std::int64_t>(lastTransaction), withdrawn);
+        }
+        // Every transaction passes through here, so the next background capture learns of it under the same lock.
+        // A batch ends with a full checkpoint, so its accounts need no tracking.
+        if (checkpointer.isRunning() && !batchActive) {
+            changedAccounts.push_back(handle);
+        }
     }
 
     /**
-     * @brief Serializes and writes all BankFunds objects to a binary file.
+     * @brief Appends a completed transaction to the journal.
+     *
+     * Converts the transaction into a compact journal record and appends it. Once the
+     * journal holds checkpointInterval records, writes a full checkpoint, or wakes the
+     * Checkpointer if checkpoints run in the background. A record the journal failed to
+     * write triggers the same checkpoint at once, since the transaction is otherwise
+     * only in memory. Does nothing while a batch is running, since the batch ends with
+     * its own checkpoint.
      *
-     * Opens "funds.dat" for binary output, writes the number of fund records,
-     * and serializes each BankFunds object.
+     * @param accountNumber Account the transaction was applied to.
+     * @param type Type of transaction.
+     * @param amount Amount of the transaction.
+     * @param resultingBalance Account balance after the transaction.
+     * @param when Time the transaction happened.
      */
-    void Storage::saveBank() {
-        std::ofstream out("funds.dat", std::ios::binary);
-
-        if (!out) {
-            std::cerr << "Error opening funds.dat for writing." << std::endl;
+    void Storage::journalTransaction(unsigned accountNumber, Account::TransactionType type, double amount,
+        double resultingBalance, std::time_t when) {
+        if (batchActive) {
             return;
         }
 
-        size_t count = funds.size();
-        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        Journal::Record record;
+        record.accountNumber = accountNumber;
+        record.type = static_cast<char>(type);
+        record.amount = amount;
+        record.resultingBalance = resultingBalance;
+        record.timestamp = static_cast<std::int64_t>(when);
 
-        for (const auto& fund : funds) {
-            fund.serialize(out);
+        bool journaled = persistence.submit(record);
+        if (journaled) {
+            metrics::increment(Counter::JournalRecords);
+        }
+        else {
+            metrics::increment(Counter::JournalWriteFailures);
+            std::cerr << "Transaction on account " << accountNumber << " was not journaled; writing a checkpoint." << std::endl;
         }
 
-        out.close();
+        if (!journaled || journal.getRecordCount() + persistence.backlog() >= checkpointInterval) {
+            if (checkpointer.isRunning()) {
+                checkpointer.request();
+            }
+            else {
+                checkpoint();
+            }
+        }
     }
 
     /**
-     * @brief Reads and deserializes BankFunds objects from a binary file.
+     * @brief Writes a full checkpoint and discards the journal.
      *
-     * Opens "funds.dat", if missing or empty, creates a default funds file.
-     * Reads the number of records and deserializes each BankFunds into storage.
+     * Both data files record the last journal sequence number they include, so the
+     * journal is only truncated after both have been written. Records still queued for
+     * the journal are written first, so the sequence number covers them. Every changed
+     * account is written, so the queue of the background checkpoints starts over.
+     *
+     * @return False if either file could not be written, in which case the journal and
+     *         the queue of changed accounts are kept.
      */
-    void Storage::loadBank() {
-        std::ifstream in("funds.dat", std::ios::binary);
+    bool Storage::checkpoint() {
+        std::lock_guard<std::mutex> serial(checkpointMutex);
+        ScopedTimer timer(Metric::Checkpoint);
+        TraceScope trace("checkpoint", "storage");
+        metrics::increment(Counter::Checkpoints);
+        bool journaled = flushJournal();
 
-        if (!in || in.peek() == std::ifstream::traits_type::eof()) {
-            std::cerr << "funds.dat not found. Creating new file." << std::endl;
+        std::uint64_t garbage = accountsGarbage;
+        bool saved = saveAccount();
+        saved = saveBank() && saved;
+        if (!saved) {
+            std::cerr << "Error writing the checkpoint; the journal is kept." << std::endl;
+            if (!journaled) {
+                std::cerr << "Transactions the journal failed to write are only in memory." << std::endl;
+            }
+            return false;
+        }
 
-            funds.clear();
+        std::uint64_t reclaimed = journal.truncate() + (accountsGarbage < garbage ? garbage : 0);
+        metrics::increment(Counter::CheckpointBytesReclaimed, reclaimed);
 
-            BankFunds defaultBank;
-            funds.push_back(defaultBank);
+        std::lock_guard<std::mutex> lock(queryIndexMutex);
+        changedAccounts.clear();
+        return true;
+    }
 
-            saveBank();
-            return;
+    /**
+     * @brief Waits for queued journal records and reports any the journal failed to write.
+     *
+     * A transaction whose record was lost is still applied in memory, and its account
+     * is still marked changed, so the checkpoint about to be written stores it. The
+     * report tells the operator that until then it exists nowhere else.
+     *
+     * @return False if a record submitted since the previous flush was not written.
+     */
+    bool Storage::flushJournal() {
+        if (persistence.flush()) {
+            return true;
         }
+        std::cerr << "Some transactions were not journaled; the checkpoint being written is their only copy on disk." << std::endl;
+        return false;
+    }
 
-        size_t count;
-        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    /**
+     * @brief Takes the transaction lock in shared mode.
+     * @return Lock held until it goes out of scope.
+     */
+    std::shared_lock<std::shared_mutex> Storage::lockForTransaction() {
+        return std::shared_lock<std::shared_mutex>(stateMutex);
+    }
 
-        if (!in || count == 0) {
-            std::cerr << "Invalid or empty data. Recreating funds.dat with default values." << std::endl;
+    /**
+     * @brief Copies what changed since the last capture and starts a new journal file.
+     *
+     * Runs under the exclusive transaction lock. Every transaction submits its journal
+     * record before releasing its shared lock, so once the queue is flushed the journal
+     * ends exactly at the last transaction reflected in the copies. Captured accounts
+     * are marked stored at once: a transaction on one of them after the capture marks it
+     * changed again, which tells the publish step not to mark it clean. Their histories
+     * stay dirty, and so resident, until the snapshot is published.
+     *
+     * @param snapshot Receives the copies.
+     * @return False if no account changed since the last capture, or a batch is running.
+     */
+    bool Storage::captureSnapshot(Snapshot& snapshot) {
+        // A batch is not journaled, so part of one must never reach the data files
+        if (batchActive) {
+            return false;
+        }
 
-            funds.clear();
+        TraceScope trace("captureSnapshot", "storage");
+        {
+            std::lock_guard<std::mutex> lock(queryIndexMutex);
+            snapshot.handles.swap(changedAccounts);
+        }
+        if (snapshot.handles.empty()) {
+            return false;
+        }
+        std::sort(snapshot.handles.begin(), snapshot.handles.end());
+        snapshot.handles.erase(std::unique(snapshot.handles.begin(), snapshot.handles.end()), snapshot.handles.end());
 
-            BankFunds defaultBank;
-            funds.push_back(defaultBank);
+        flushJournal();
+        snapshot.sequence = journal.getLastSequence();
 
-            saveBank();
-            return;
+        // A changed history is always resident; one that is not is read for the copy alone,
+        // since loading it could evict a history another thread is reading
+        snapshot.accounts.reserve(snapshot.handles.size());
+        for (AccountHandle handle : snapshot.handles) {
+            Account& acc = accounts[handle];
+            snapshot.accounts.push_back(acc);
+            if (!acc.isHistoryLoaded()) {
+                snapshot.accounts.back().restoreHistory(readStoredHistory(acc));
+            }
+            acc.markRecordStored();
         }
+        snapshot.funds = funds;
+        snapshot.accountCount = accounts.size();
+        snapshot.lastAccountNumber = lastAccountNumber;
+        snapshot.sealed = journal.seal();
+        return true;
+    }
 
-        funds.clear();
+    /**
+     * @brief Writes the captured accounts into the existing file with an AccountFileUpdater.
+     *
+     * Gives up before writing anything under the same conditions as saveAccount, or if
+     * an account created since the file was written is somehow missing from the
+     * snapshot, since its slot would otherwise be left empty.
+     *
+     * @param snapshot Captured accounts.
+     * @param historyOffsets Receives the history offset of each captured account, in the order of snapshot.handles.
+     * @return False if nothing was committed and the file needs a full rewrite.
+     */
+    bool Storage::writeSnapshotInPlace(const Snapshot& snapshot, std::vector<std::uint64_t>& historyOffsets) {
+        std::string accountsPath = dataPath("accounts.dat");
+        AccountFileUpdater updater(accountsPath);
+        if (!updater.isOpen() || !updater.canHold(snapshot.accountCount) || accountsGarbage > updater.getHeader().heapSize / 2) {
+            return false;
+        }
 
-        for (size_t i = 0; i < count; ++i) {
-            BankFunds temp;
-            temp.deserialize(in);
-            funds.push_back(temp);
+        std::uint64_t stored = updater.getHeader().accountCount;
+        auto firstNew = std::lower_bound(snapshot.handles.begin(), snapshot.handles.end(), stored);
+        if (snapshot.accountCount < stored || static_cast<std::uint64_t>(snapshot.handles.end() - firstNew) != snapshot.accountCount - stored) {
+            return false;
         }
 
-        std::cout << "Successfully loaded fund entries." << std::endl;
-        in.close();
+        TraceScope trace("writeSnapshotInPlace", "storage");
+        historyOffsets.clear();
+        historyOffsets.reserve(snapshot.handles.size());
+        for (std::size_t i = 0; i < snapshot.handles.size(); ++i) {
+            historyOffsets.push_back(updater.update(snapshot.handles[i], snapshot.accounts[i], snapshot.sequence).historyOffset);
+        }
+
+        if (!updater.commit(snapshot.accountCount, snapshot.sequence, snapshot.lastAccountNumber)) {
+            std::cerr << "Error updating " << accountsPath << "; rewriting it." << std::endl;
+            return false;
+        }
+        accountsGarbage += updater.getReleasedBytes();
+        return true;
+    }
+
+    /**
+     * @brief Writes "accounts.dat.tmp" from the snapshot and the unchanged blocks of the current file.
+     *
+     * Accounts that did not change since the last capture are exactly as the current
+     * file stores them, so their blocks are copied from it instead of from memory that
+     * transactions may be changing. The caller moves the new file into place.
+     *
+     * @param snapshot Captured accounts.
+     * @param historyOffsets Receives the history offset of every account, by handle.
+     * @return False if the current file is missing, older than version 4, or damaged, or if the new one was not written.
+     */
+    bool Storage::compactSnapshot(const Snapshot& snapshot, std::vector<std::uint64_t>& historyOffsets) {
+        std::string accountsPath = dataPath("accounts.dat");
+        MappedFile current;
+        if (!current.open(accountsPath) || current.getSize() < sizeof(accountFile::FileHeader)) {
+            return false;
+        }
+
+        accountFile::FileHeader header;
+        std::memcpy(&header, current.getData(), sizeof(header));
+        if (std::memcmp(header.magic, accountFile::magic, sizeof(header.magic)) != 0
+            || header.version < accountFile::firstUpdatableVersion || header.version > accountFile::currentVersion
+            || header.heapOffset > current.getSize() || snapshot.accountCount < header.accountCount) {
+            return false;
+        }
+
+        auto firstNew = std::lower_bound(snapshot.handles.begin(), snapshot.handles.end(), header.accountCount);
+        if (static_cast<std::uint64_t>(snapshot.handles.end() - firstNew) != snapshot.accountCount - header.accountCount) {
+            return false;
+        }
+
+        TraceScope trace("compactSnapshot", "storage");
+        const char* heap = current.getData() + header.heapOffset;
+        std::uint64_t heapSize = std::min<std::uint64_t>(header.heapSize, current.getSize() - header.heapOffset);
+        std::string tempPath = dataPath("accounts.dat.tmp");
+        AccountFileWriter writer(tempPath, snapshot.accountCount, snapshot.sequence, snapshot.lastAccountNumber);
+        if (!writer.isOpen()) {
+            std::cerr << "Error opening " << tempPath << " for writing." << std::endl;
+            return false;
+        }
+
+        historyOffsets.assign(static_cast<std::size_t>(snapshot.accountCount), 0);
+        std::size_t next = 0;
+        for (AccountHandle handle = 0; handle < snapshot.accountCount; ++handle) {
+            if (next < snapshot.handles.size() && snapshot.handles[next] == handle) {
+                historyOffsets[handle] = writer.add(snapshot.accounts[next++]).historyOffset;
+                continue;
+            }
+
+            accountFile::AccountRecord record;
+            std::uint64_t recordOffset = header.recordTableOffset + handle * sizeof(record);
+            if (recordOffset + sizeof(record) > current.getSize()) {
+                std::cerr << "accounts.dat record table is truncated." << std::endl;
+                return false;
+            }
+            std::memcpy(&record, current.getData() + recordOffset, sizeof(record));
+            if (!inHeap(heapSize, record.firstName.offset, record.firstName.length)
+                || !inHeap(heapSize, record.lastName.offset, record.lastName.length)
+                || !inHeap(heapSize, record.password.offset, record.password.length)
+                || !inHeap(heapSize, record.historyOffset, record.historyCount * sizeof(accountFile::HistoryRecord))) {
+                std::cerr << "accounts.dat heap is truncated." << std::endl;
+                return false;
+            }
+            historyOffsets[handle] = writer.addStored(record, heap).historyOffset;
+        }
+
+        if (!writer.finish()) {
+            std::cerr << "Error writing " << tempPath << "." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes a checkpoint from a snapshot, holding transactions off only to capture and publish it.
+     *
+     * The steps, each of which leaves a loadable set of files if the process stops:
+     * 1. Capture, under the exclusive transaction lock: copy the changed accounts and the
+     *    funds, seal the journal.
+     * 2. Write the copies into accounts.dat in place, or compact it into a new file, and
+     *    write funds.dat. Both record the snapshot's journal sequence, so the sealed
+     *    records they include are skipped on replay.
+     * 3. Publish, under the exclusive lock again: move a compacted file into place,
+     *    remember where the histories now live, and map the file again in lazy mode.
+     * 4. Delete the sealed journal, now that both files include it.
+     *
+     * If accounts.dat cannot be updated from the snapshot at all (it is missing or in an
+     * older layout), the checkpoint is written from memory with transactions held off. If
+     * it cannot be written either way, the captured accounts are queued for the next
+     * checkpoint and the sealed journal stays.
+     *
+     * @param report Receives the duration, the pause, and the bytes reclaimed.
+     * @return False if nothing had changed, a batch is running, or the accounts could not be written.
+     */
+    bool Storage::backgroundCheckpoint(CheckpointReport& report) {
+        using Clock = std::chrono::steady_clock;
+        std::lock_guard<std::mutex> serial(checkpointMutex);
+        TraceScope trace("backgroundCheckpoint", "storage");
+        auto start = Clock::now();
+        std::string accountsPath = dataPath("accounts.dat");
+
+        Snapshot snapshot;
+        {
+            std::unique_lock<std::shared_mutex> exclusive(stateMutex);
+            if (!captureSnapshot(snapshot)) {
+                return false;
+            }
+        }
+        Clock::duration paused = Clock::now() - start;
+
+        std::vector<std::uint64_t> historyOffsets;
+        bool compacted = false;
+        bool written = writeSnapshotInPlace(snapshot, historyOffsets);
+        if (!written) {
+            compacted = written = compactSnapshot(snapshot, historyOffsets);
+        }
+        bool fundsWritten = written && writeFunds(snapshot.funds, snapshot.sequence);
+
+        report = CheckpointReport();
+        {
+            auto publishing = Clock::now();
+            std::unique_lock<std::shared_mutex> exclusive(stateMutex);
+            std::lock_guard<std::mutex> history(historyMutex);
+            TraceScope publishTrace("publishSnapshot", "storage");
+
+            if (compacted) {
+                accountsFile.close();
+                written = replaceFile(dataPath("accounts.dat.tmp"), accountsPath);
+            }
+
+            if (!written) {
+                // Nothing usable from memory at the capture; write the current state instead
+                std::uint64_t garbage = accountsGarbage;
+                flushJournal();
+                written = compactAccounts() && writeFunds(funds, journal.getLastSequence());
+                if (written) {
+                    report.journalBytesReclaimed = journal.truncate();
+                    report.heapBytesReclaimed = garbage;
+                    report.accountsWritten = accounts.size();
+                    report.compacted = true;
+
+                    std::lock_guard<std::mutex> lock(queryIndexMutex);
+                    changedAccounts.clear();
+                }
+                else {
+                    std::cerr << "Error writing the checkpoint; the journal is kept." << std::endl;
+                    for (AccountHandle handle : snapshot.handles) {
+                        accounts[handle].markRecordDirty();
+                    }
+                    std::lock_guard<std::mutex> lock(queryIndexMutex);
+                    changedAccounts.insert(changedAccounts.end(), snapshot.handles.begin(), snapshot.handles.end());
+                }
+            }
+            else {
+                if (compacted) {
+                    // Unchanged histories were copied to new places; changed ones get theirs below
+                    for (AccountHandle handle = 0; handle < snapshot.accountCount; ++handle) {
+                        if (!accounts[handle].isHistoryDirty()) {
+                            accounts[handle].markHistoryStored(historyOffsets[handle]);
+                        }
+                    }
+                    report.heapBytesReclaimed = accountsGarbage;
+                    accountsGarbage = 0;
+                }
+                for (std::size_t i = 0; i < snapshot.handles.size(); ++i) {
+                    AccountHandle handle = snapshot.handles[i];
+                    if (!accounts[handle].isRecordModified()) {
+                        accounts[handle].markHistoryStored(compacted ? historyOffsets[handle] : historyOffsets[i]);
+                    }
+                }
+                report.accountsWritten = snapshot.handles.size();
+                report.compacted = compacted;
+
+                if (lazyHistory) {
+                    accountsFile.close();
+                    if (accountsFile.open(accountsPath) && accountsFile.getSize() >= sizeof(accountFile::FileHeader)) {
+                        accountFile::FileHeader header;
+                        std::memcpy(&header, accountsFile.getData(), sizeof(header));
+                        accountsHeapOffset = header.heapOffset;
+                        accountsVersion = header.version;
+                    }
+                }
+            }
+            paused += Clock::now() - publishing;
+        }
+
+        if (!written) {
+            return false;
+        }
+        if (compacted) {
+            syncDirectoryOf(accountsPath);
+        }
+        if (fundsWritten && snapshot.sealed) {
+            report.journalBytesReclaimed = journal.discardSealed();
+        }
+
+        report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        report.pauseSeconds = std::chrono::duration<double>(paused).count();
+        metrics::record(Metric::Checkpoint, static_cast<std::uint64_t>(report.seconds * 1e9));
+        metrics::record(Metric::CheckpointPause, static_cast<std::uint64_t>(report.pauseSeconds * 1e9));
+        metrics::increment(Counter::Checkpoints);
+        metrics::increment(Counter::CheckpointBytesReclaimed, report.journalBytesReclaimed + report.heapBytesReclaimed);
+        return true;
+    }
+
+    /**
+     * @brief Starts, restarts or stops the Checkpointer.
+     *
+     * Transactions only queue their accounts for the background checkpoints while the
+     * thread runs, so the accounts already dirty are queued when it starts.
+     *
+     * @param period Longest time between background checkpoints; zero for inline checkpoints.
+     */
+    void Storage::setCheckpointPeriod(std::chrono::milliseconds period) {
+        checkpointer.stop();
+        {
+            std::lock_guard<std::mutex> lock(queryIndexMutex);
+            changedAccounts.clear();
+            for (AccountHandle handle = 0; period.count() > 0 && handle < accounts.size(); ++handle) {
+                if (accounts[handle].isRecordDirty()) {
+                    changedAccounts.push_back(handle);
+                }
+            }
+        }
+        checkpointer.start(period);
+    }
+
+    /**
+     * @brief Gets the last and total background checkpoint reports.
+     * @param last Receives the report of the most recent one.
+     * @param totals Receives the sum of every report.
+     * @return Number of background checkpoints written.
+     */
+    std::uint64_t Storage::getCheckpointReports(CheckpointReport& last, CheckpointReport& totals) {
+        last = checkpointer.getLastReport();
+        totals = checkpointer.getTotals();
+        return checkpointer.getCount();
+    }
+
+    /**
+     * @brief Stops journaling individual transactions, and background checkpoints, until endBatch.
+     */
+    void Storage::beginBatch() {
+        batchActive = true;
+    }
+
+    /**
+     * @brief Writes one checkpoint covering the whole batch, then resumes journaling.
+     */
+    void Storage::endBatch() {
+        checkpoint();
+        batchActive = false;
+    }
+
+    /**
+     * @brief Checks whether a batch is running.
+     * @return True between beginBatch and the end of endBatch.
+     */
+    bool Storage::isBatchActive() const {
+        return batchActive;
+    }
+
+    /**
+     * @brief Checks whether checkpoints run on the Checkpointer thread.
+     * @return True while a checkpoint period is set.
+     */
+    bool Storage::isCheckpointerRunning() const {
+        return checkpointer.isRunning();
+    }
+
+    /**
+     * @brief Changes when a transaction may report success relative to its journal write.
+     * @param mode New durability mode.
+     */
+    void Storage::setDurability(PersistenceWorker::Durability mode) {
+        persistence.setDurability(mode);
+    }
+
+    /**
+     * @brief Gets the current durability mode.
+     * @return Mode in effect.
+     */
+    PersistenceWorker::Durability Storage::getDurability() const {
+        return persistence.getDurability();
+    }
+
+    /**
+     * @brief Sets the group commit window and batch size of the persistence thread.
+     *
+     * @param window How long the thread waits for more records before an fsync.
+     * @param maxBatch Most records made durable by one fsync.
+     */
+    void Storage::setGroupCommit(std::chrono::microseconds window, std::size_t maxBatch) {
+        persistence.setCommitWindow(window);
+        persistence.setMaxBatch(maxBatch);
+    }
+
+    /**
+     * @brief Sets how many journaled transactions trigger an automatic checkpoint.
+     * @param interval Record count; at least 1.
+     */
+    void Storage::setCheckpointInterval(std::size_t interval) {
+        checkpointInterval = interval > 0 ? interval : 1;
+    }
+
+    /**
+     * @brief Writes the accounts changed since the last save to "accounts.dat".
+     *
+     * Updates the file in place when it is in the current layout, touching only dirty
+     * records, their new history entries and the header. Falls back to a compaction if
+     * the file is missing or older, the record table has no spare slots left, blocks
+     * that moved away take up more than half the heap, or an in-place write fails.
+     *
+     * @return False if neither the update nor the compaction could be written.
+     */
+    bool Storage::saveAccount() {
+        ScopedTimer timer(Metric::SaveAccount);
+        TraceScope trace("saveAccount", "storage");
+        return updateAccountsInPlace() || compactAccounts();
+    }
+
+    /**
+     * @brief Writes the dirty accounts into the existing file.
+     *
+     * A changed history is always loaded, because a dirty history is never evicted; a
+     * record changed some other way has its history paged in, in case its block has to
+     * move. Old blocks are never overwritten, so if the update fails halfway the mapped file
+     * still serves every stored history and compactAccounts can take over. In lazy
+     * mode the file is mapped again afterwards, so moved blocks can be paged in.
+     *
+     * @return False if nothing was committed and the file needs a full rewrite.
+     */
+    bool Storage::updateAccountsInPlace() {
+        std::string accountsPath = dataPath("accounts.dat");
+        AccountFileUpdater updater(accountsPath);
+        if (!updater.isOpen() || !updater.canHold(accounts.size()) || accountsGarbage > updater.getHeader().heapSize / 2) {
+            return false;
+        }
+
+        TraceScope trace("updateAccountsInPlace", "storage");
+        std::uint64_t sequence = journal.getLastSequence();
+        std::vector<std::pair<AccountHandle, std::uint64_t>> updated;
+        for (AccountHandle handle = 0; handle < accounts.size(); ++handle) {
+            if (accounts[handle].isRecordDirty() || handle >= updater.getHeader().accountCount) {
+                loadHistory(accounts[handle]);
+                updated.emplace_back(handle, updater.update(handle, accounts[handle], sequence).historyOffset);
+            }
+        }
+
+        if (!updater.commit(accounts.size(), sequence, lastAccountNumber)) {
+            std::cerr << "Error updating " << accountsPath << "; rewriting it." << std::endl;
+            return false;
+        }
+
+        for (const auto& entry : updated) {
+            accounts[entry.first].markHistoryStored(entry.second);
+            accounts[entry.first].markRecordStored();
+        }
+        accountsGarbage += updater.getReleasedBytes();
+
+        if (lazyHistory) {
+            accountsFile.close();
+            if (accountsFile.open(accountsPath)) {
+                accountsHeapOffset = updater.getHeader().heapOffset;
+                accountsVersion = accountFile::currentVersion;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Rewrites "accounts.dat" in the current layout.
+     *
+     * Streams the accounts through an AccountFileWriter in a single pass. Histories
+     * that are not loaded are copied from the current file, so the new file is written
+     * next to it, synced, and then moved over it; the directory is synced so the move
+     * itself survives a crash. Afterwards every account is clean and remembers its new
+     * offset.
+     *
+     * @return False if the new file could not be written or moved into place.
+     */
+    bool Storage::compactAccounts() {
+        TraceScope trace("compactAccounts", "storage");
+        std::string tempPath = dataPath("accounts.dat.tmp");
+        std::string accountsPath = dataPath("accounts.dat");
+        AccountFileWriter writer(tempPath, accounts.size(), journal.getLastSequence(), lastAccountNumber);
+
+        if (!writer.isOpen()) {
+            std::cerr << "Error opening " << tempPath << " for writing." << std::endl;
+            return false;
+        }
+
+        std::vector<std::uint64_t> historyOffsets;
+        historyOffsets.reserve(accounts.size());
+        for (const auto& acc : accounts) {
+            historyOffsets.push_back((acc.isHistoryLoaded() ? writer.add(acc) : writer.add(acc, readStoredHistory(acc))).historyOffset);
+        }
+
+        if (!writer.finish()) {
+            std::cerr << "Error writing " << tempPath << "." << std::endl;
+            return false;
+        }
+
+        // The old file must be unmapped before it can be replaced on every platform
+        accountsFile.close();
+        if (!replaceFile(tempPath, accountsPath)) {
+            std::cerr << "Error replacing accounts.dat." << std::endl;
+            return false;
+        }
+        syncDirectoryOf(accountsPath);
+
+        for (AccountHandle handle = 0; handle < accounts.size(); ++handle) {
+            accounts[handle].markHistoryStored(historyOffsets[handle]);
+            accounts[handle].markRecordStored();
+        }
+        accountsGarbage = 0;
+
+        if (lazyHistory && accountsFile.open(accountsPath)) {
+            accountsHeapOffset = writer.getHeapOffset();
+            accountsVersion = accountFile::currentVersion;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Reads an account's history from the mapped accounts.dat without keeping it.
+     *
+     * @param account Account whose history is not loaded.
+     * @return Transactions in chronological order, or none if the file is not mapped.
+     */
+    Account::History Storage::readStoredHistory(const Account& account) const {
+        if (!accountsFile.isOpen() || accountsHeapOffset > accountsFile.getSize()) {
+            return Account::History(account.getHistoryResource());
+        }
+
+        return readHeapHistory(accountsFile.getData() + accountsHeapOffset, accountsFile.getSize() - accountsHeapOffset,
+            accountsVersion, account.getHistoryOffset(), account.getTransactionCount(), account.getHistoryResource());
+    }
+
+    /**
+     * @brief Makes sure an account's transaction history is in memory.
+     *
+     * Pages the history in from accounts.dat on first access. In lazy history mode it
+     * also marks the history as most recently used and evicts the least recently used
+     * clean histories until the resident total fits the memory budget. The bookkeeping
+     * is shared by all accounts, so it runs under historyMutex; a history loaded for
+     * update is marked dirty before the lock is released so no other thread can evict
+     * it before the caller appends to it.
+     *
+     * @param account Account stored in this Storage, or one the caller keeps itself (never tracked).
+     * @param forUpdate True if the caller is about to append a transaction.
+     */
+    void Storage::loadHistory(Account& account, bool forUpdate) {
+        if (!lazyHistory) {
+            // Histories are never evicted outside lazy mode, so no lock is needed
+            if (!account.isHistoryLoaded()) {
+                account.restoreHistory(readStoredHistory(account));
+                metrics::increment(Counter::HistoryPageIns);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(historyMutex);
+
+        if (!account.isHistoryLoaded()) {
+            account.restoreHistory(readStoredHistory(account));
+            metrics::increment(Counter::HistoryPageIns);
+        }
+        if (forUpdate) {
+            account.markHistoryDirty();
+        }
+
+        // Accounts kept outside the container, such as a benchmark's own, are not tracked or evicted
+        AccountHandle handle = handleOf(account);
+        if (handle == noAccount) {
+            return;
+        }
+
+        auto resident = historyResidents.find(handle);
+        if (resident != historyResidents.end()) {
+            residentHistoryBytes -= resident->second.second;
+            historyLru.erase(resident->second.first);
+        }
+
+        std::size_t bytes = account.getHistoryMemory();
+        historyLru.push_front(handle);
+        historyResidents[handle] = std::make_pair(historyLru.begin(), bytes);
+        residentHistoryBytes += bytes;
+
+        evictHistories(handle);
+    }
+
+    /**
+     * @brief Releases least recently used histories until the budget is met.
+     *
+     * Dirty histories hold transactions that are only in the journal, so they stay in
+     * memory until the next checkpoint has written them.
+     *
+     * @param keep Handle of the history being used right now, which is never evicted.
+     */
+    void Storage::evictHistories(AccountHandle keep) {
+        auto it = historyLru.end();
+        while (residentHistoryBytes > historyBudget && it != historyLru.begin()) {
+            --it;
+            AccountHandle handle = *it;
+            if (handle == keep || accounts[handle].isHistoryDirty()) {
+                continue;
+            }
+
+            auto resident = historyResidents.find(handle);
+            residentHistoryBytes -= resident->second.second;
+            historyResidents.erase(resident);
+            accounts[handle].releaseHistory();
+            metrics::increment(Counter::HistoryEvictions);
+            it = historyLru.erase(it);
+        }
+    }
+
+    /**
+     * @brief Chooses whether histories are loaded at startup or on first use.
+     *
+     * Takes effect on the next loadAccount.
+     *
+     * @param enabled True to load only account headers at startup.
+     * @param budgetBytes Memory allowed for resident histories before eviction starts.
+     */
+    void Storage::setLazyHistory(bool enabled, std::size_t budgetBytes) {
+        lazyHistory = enabled;
+        historyBudget = budgetBytes;
+    }
+
+    /**
+     * @brief Chooses how many threads read a mapped accounts.dat.
+     *
+     * Takes effect on the next loadAccount.
+     *
+     * @param threads Thread count; 0 for std::thread::hardware_concurrency.
+     */
+    void Storage::setLoadThreads(unsigned threads) {
+        loadThreads = threads;
+    }
+
+    /**
+     * @brief Reads a version 1 "accounts.dat" stream field by field.
+     *
+     * Reads the account count, deserializes each account in place, then the last assigned
+     * account number. Files written before the journal existed have no sequence number
+     * and are treated as sequence 0.
+     *
+     * Capacity is reserved up front, but never for more accounts than the rest of the
+     * file could hold, so a corrupt count cannot trigger a huge allocation.
+     *
+     * @param in Stream positioned at the start of the file.
+     * @return Last journal sequence number included in the file.
+     */
+    std::uint64_t Storage::loadAccountsV1(std::istream& in) {
+        TraceScope trace("loadAccountsV1", "startup");
+        size_t count;
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+        // Smallest possible account: three string lengths, number, balance, history count
+        const std::streamoff minAccountSize = 3 * sizeof(size_t) + sizeof(unsigned) + sizeof(double) + sizeof(int);
+        std::streamoff start = in.tellg();
+        in.seekg(0, std::ios::end);
+        std::streamoff remaining = in.tellg() - start;
+        in.seekg(start);
+        accounts.reserve(std::min<size_t>(count, static_cast<size_t>(remaining / minAccountSize)));
+
+        for (size_t i = 0; i < count; ++i) {
+            accounts.emplace_back(historyResource());
+            accounts.back().deserialize(in);
+        }
+
+        in.read(reinterpret_cast<char*>(&lastAccountNumber), sizeof(lastAccountNumber));
+
+        std::uint64_t sequence = 0;
+        if (!in.read(reinterpret_cast<char*>(&sequence), sizeof(sequence))) {
+            sequence = 0;
+        }
+        return sequence;
+    }
+
+    /**
+     * @brief Builds accounts from a memory-mapped version 2 to 4 "accounts.dat".
+     *
+     * Reads the record table and heap in place. Every offset is checked against the
+     * mapped size before it is followed, so a truncated file loads as many complete
+     * accounts as it holds. In lazy history mode only the account headers are built;
+     * each history just remembers its heap offset.
+     *
+     * The record table has a fixed-size record per account, so record i is found
+     * without reading the ones before it. The accounts are created empty first, then
+     * filled in chunks of loadChunkAccounts by up to loadThreads threads, each taking
+     * the next unclaimed chunk, so skewed history lengths still spread evenly. Every
+     * account is written by exactly one thread and the history arena serializes its own
+     * allocations, so the threads share nothing else.
+     *
+     * Version 4 records also give the journal sequence each account is current to, and
+     * the heap not covered by any block is counted as garbage for the next save.
+     *
+     * @param file Mapped file, already known to start with the version 2 magic.
+     * @param accountSequences Receives the journal sequence of each account, or 0.
+     * @return Last journal sequence number included in the file.
+     */
+    std::uint64_t Storage::loadAccountsMapped(const MappedFile& file, std::vector<std::uint64_t>& accountSequences) {
+        TraceScope trace("loadAccountsMapped", "startup");
+        const char* base = file.getData();
+        std::size_t size = file.getSize();
+
+        accountFile::FileHeader header;
+        if (size < sizeof(header)) {
+            std::cerr << "accounts.dat header is truncated." << std::endl;
+            return 0;
+        }
+        std::memcpy(&header, base, sizeof(header));
+
+        if (header.version < accountFile::firstMappedVersion || header.version > accountFile::currentVersion) {
+            std::cerr << "accounts.dat has unsupported version " << header.version << "." << std::endl;
+            return 0;
+        }
+
+        lastAccountNumber = header.lastAccountNumber;
+
+        const char* heap = base + header.heapOffset;
+        std::uint64_t heapSize = header.heapOffset <= size ? std::min<std::uint64_t>(header.heapSize, size - header.heapOffset) : 0;
+        accountsHeapOffset = header.heapOffset;
+        accountsVersion = header.version;
+        std::uint64_t historyRecordSize = accountFile::historyRecordSize(header.version);
+        std::uint64_t recordSize = accountFile::accountRecordSize(header.version);
+        bool updatable = header.version >= accountFile::firstUpdatableVersion;
+
+        std::uint64_t tableRecords = header.recordTableOffset <= size ? (size - header.recordTableOffset) / recordSize : 0;
+        std::size_t count = static_cast<std::size_t>(std::min(header.accountCount, tableRecords));
+
+        // Every account gets its history resource here, so the threads only fill them in
+        accounts.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            accounts.emplace_back(historyResource());
+        }
+        accountSequences.assign(count, 0);
+
+        // Accounts read from one chunk, stopping at the first record that points outside the heap
+        struct ChunkResult {
+            std::size_t loaded = 0;
+            std::uint64_t liveHeap = 0;
+        };
+        std::size_t chunkCount = (count + loadChunkAccounts - 1) / loadChunkAccounts;
+        std::vector<ChunkResult> chunks(chunkCount);
+        std::atomic<std::size_t> nextChunk{ 0 };
+
+        auto readChunks = [&]() {
+            for (std::size_t chunk = nextChunk++; chunk < chunkCount; chunk = nextChunk++) {
+                TraceScope chunkTrace("readAccountChunk", "startup");
+                std::size_t first = chunk * loadChunkAccounts;
+                std::size_t last = std::min(first + loadChunkAccounts, count);
+                ChunkResult& result = chunks[chunk];
+
+                for (std::size_t i = first; i < last; ++i) {
+                    accountFile::AccountRecord record = {};
+                    std::memcpy(&record, base + header.recordTableOffset + i * recordSize, static_cast<std::size_t>(recordSize));
+                    if (!inHeap(heapSize, record.firstName.offset, record.firstName.length)
+                        || !inHeap(heapSize, record.lastName.offset, record.lastName.length)
+                        || !inHeap(heapSize, record.password.offset, record.password.length)
+                        || !inHeap(heapSize, record.historyOffset, record.historyCount * historyRecordSize)) {
+                        break;
+                    }
+
+                    Account& acc = accounts[i];
+                    acc.setHolderFirstName(heapText(heap, record.firstName));
+                    acc.setHolderLastName(heapText(heap, record.lastName));
+                    acc.setHolderAccountNumber(record.accountNumber);
+                    acc.setHolderPassword(heapText(heap, record.password));
+                    acc.setBalance(record.balance);
+
+                    int historyCount = static_cast<int>(record.historyCount);
+                    if (lazyHistory) {
+                        acc.setStoredHistory(record.historyOffset, historyCount);
+                    }
+                    else {
+                        acc.restoreHistory(readHeapHistory(heap, heapSize, header.version, record.historyOffset, historyCount,
+                            acc.getHistoryResource()));
+                        acc.markHistoryStored(record.historyOffset);
+                    }
+                    acc.markRecordStored();
+
+                    accountSequences[i] = record.journalSequence;
+                    if (updatable) {
+                        result.liveHeap += accountFile::blockSize(record);
+                    }
+                    ++result.loaded;
+                }
+            }
+        };
+
+        unsigned threadCount = loadThreads > 0 ? loadThreads : std::max(std::thread::hardware_concurrency(), 1u);
+        threadCount = static_cast<unsigned>(std::min<std::size_t>(threadCount, chunkCount));
+        if (threadCount <= 1) {
+            readChunks();
+        }
+        else {
+            std::vector<std::thread> workers;
+            for (unsigned t = 1; t < threadCount; ++t) {
+                workers.emplace_back(readChunks);
+            }
+            readChunks();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+        }
+
+        // As when reading in order, nothing after the first damaged record is kept
+        std::size_t loaded = 0;
+        std::uint64_t liveHeap = 0;
+        for (std::size_t chunk = 0; chunk < chunkCount; ++chunk) {
+            loaded += chunks[chunk].loaded;
+            liveHeap += chunks[chunk].liveHeap;
+            if (loaded < std::min((chunk + 1) * loadChunkAccounts, count)) {
+                std::cerr << "accounts.dat heap is truncated." << std::endl;
+                break;
+            }
+        }
+        if (loaded == count && count < header.accountCount) {
+            std::cerr << "accounts.dat record table is truncated." << std::endl;
+        }
+        accounts.erase(accounts.begin() + static_cast<std::ptrdiff_t>(loaded), accounts.end());
+        accountSequences.resize(loaded);
+
+        accountsGarbage = updatable && heapSize > liveHeap ? heapSize - liveHeap : 0;
+        return header.journalSequence;
+    }
+
+    /**
+     * @brief Loads accounts from "accounts.dat" in either on-disk layout.
+     *
+     * Creates the file with default values if missing. A file starting with the
+     * version 2 magic is memory mapped and read in place; anything else is read as
+     * the original version 1 stream. In lazy history mode a mapped file stays mapped
+     * so histories can be paged in later. Then rebuilds the indexes and replays every
+     * journaled transaction newer than the file.
+     */
+    void Storage::loadAccount() {
+        ScopedTimer timer(Metric::LoadAccount);
+        TraceScope trace("loadAccount", "startup");
+        historyLru.clear();
+        historyResidents.clear();
+        residentHistoryBytes = 0;
+
+        // Drop everything allocated from the arena, then reclaim it in one go
+        accounts.clear();
+        accountNumberIndex = decltype(accountNumberIndex)(&accountArena);
+        lastNameIndex = decltype(lastNameIndex)(&accountArena);
+        accountArena.release();
+
+        std::uint64_t sequence = 0;
+        std::vector<std::uint64_t> accountSequences;
+        accountsGarbage = 0;
+        std::string accountsPath = dataPath("accounts.dat");
+        if (accountsFile.open(accountsPath)) {
+            if (accountsFile.getSize() >= sizeof(accountFile::magic)
+                && std::memcmp(accountsFile.getData(), accountFile::magic, sizeof(accountFile::magic)) == 0) {
+                sequence = loadAccountsMapped(accountsFile, accountSequences);
+            }
+            else {
+                accountsFile.close();
+                std::ifstream in(accountsPath, std::ios::binary);
+                sequence = loadAccountsV1(in);
+            }
+
+            if (!lazyHistory) {
+                accountsFile.close();
+            }
+        }
+        else {
+            std::cerr << "accounts.dat not found. Creating a new file." << std::endl;
+            saveAccount();
+        }
+
+        rebuildIndexes();
+
+        std::vector<Journal::Record> tail;
+        std::size_t replayed = 0;
+        {
+            TraceScope replayTrace("replayJournal", "startup");
+            journal.advanceTo(sequence);
+            tail = journal.readAfter(sequence);
+
+            for (const auto& record : tail) {
+                AccountHandle handle = findByAccountNumber(record.accountNumber);
+                if (handle == noAccount) {
+                    std::cerr << "Journal entry for unknown account #" << record.accountNumber << " skipped." << std::endl;
+                    continue;
+                }
+                // Already stored by a save that was interrupted before it finished
+                if (handle < accountSequences.size() && record.sequence <= accountSequences[handle]) {
+                    continue;
+                }
+                ++replayed;
+
+                Account& acc = accounts[handle];
+                loadHistory(acc);
+                acc.setBalance(record.resultingBalance);
+                acc.recordTransaction(static_cast<Account::TransactionType>(record.type), record.amount,
+                    record.resultingBalance, static_cast<std::time_t>(record.timestamp));
+            }
+        }
+
+        rebuildQueryIndex();
+
+        std::cout << "Successfully loaded account entries." << std::endl;
+        if (replayed > 0) {
+            std::cout << "Replayed " << replayed << " journaled transactions." << std::endl;
+        }
+    }
+
+    /**
+     * @brief Serializes and writes all BankFunds objects to a binary file.
+     *
+     * Writes the current records with the last journal sequence number; see writeFunds.
+     *
+     * @return False if the file could not be written.
+     */
+    bool Storage::saveBank() {
+        return writeFunds(funds, journal.getLastSequence());
+    }
+
+    /**
+     * @brief Writes fund records to "funds.dat" through a temporary file.
+     *
+     * Writes the number of fund records, serializes each BankFunds object, then the
+     * last journal sequence number the file includes, then each fund's volume buckets.
+     * The buckets come last so that files written before they existed still load. The
+     * file is synced and renamed over the old one, so a background checkpoint that stops
+     * halfway leaves the previous totals, which the journal still covers.
+     *
+     * @param records Fund records to write.
+     * @param sequence Last journal record they include.
+     * @return False if the file was not replaced.
+     */
+    bool Storage::writeFunds(const std::vector<BankFunds>& records, std::uint64_t sequence) {
+        ScopedTimer timer(Metric::SaveBank);
+        TraceScope trace("saveBank", "storage");
+        std::ostringstream out(std::ios::binary);
+
+        size_t count = records.size();
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+
+        for (const auto& fund : records) {
+            fund.serialize(out);
+        }
+
+        out.write(reinterpret_cast<const char*>(&sequence), sizeof(sequence));
+
+        for (const auto& fund : records) {
+            fund.getVolume().serialize(out);
+        }
+
+        std::string bytes = out.str();
+        std::string tempPath = dataPath("funds.dat.tmp");
+        std::string fundsPath = dataPath("funds.dat");
+        std::remove(tempPath.c_str());
+        DurableFile file;
+        if (!file.openForAppend(tempPath)) {
+            std::cerr << "Error opening funds.dat for writing." << std::endl;
+            return false;
+        }
+        if (!file.write(bytes.data(), bytes.size()) || !file.sync()) {
+            std::cerr << "Error writing " << tempPath << "." << std::endl;
+            return false;
+        }
+        file.close();
+
+        if (!replaceFile(tempPath, fundsPath)) {
+            std::cerr << "Error replacing funds.dat." << std::endl;
+            return false;
+        }
+        syncDirectoryOf(fundsPath);
+        return true;
+    }
+
+    /**
+     * @brief Reads and deserializes BankFunds objects from a binary file.
+     *
+     * Opens "funds.dat", if missing or empty, creates a default funds file.
+     * Reads the number of records and deserializes each BankFunds into storage,
+     * along with their volume buckets when the file has them, then applies every
+     * journaled transaction newer than the file to the totals and buckets.
+     */
+    void Storage::loadBank() {
+        TraceScope trace("loadBank", "startup");
+        std::ifstream in(dataPath("funds.dat"), std::ios::binary);
+
+        if (!in || in.peek() == std::ifstream::traits_type::eof()) {
+            std::cerr << "funds.dat not found. Creating new file." << std::endl;
+
+            funds.clear();
+
+            BankFunds defaultBank;
+            funds.push_back(defaultBank);
+
+            saveBank();
+            return;
+        }
+
+        size_t count;
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+
+        if (!in || count == 0) {
+            std::cerr << "Invalid or empty data. Recreating funds.dat with default values." << std::endl;
+
+            funds.clear();
+
+            BankFunds defaultBank;
+            funds.push_back(defaultBank);
+
+            saveBank();
+            return;
+        }
+
+        funds.clear();
+
+        for (size_t i = 0; i < count; ++i) {
+            BankFunds temp;
+            temp.deserialize(in);
+            funds.push_back(temp);
+        }
+
+        std::uint64_t sequence = 0;
+        if (!in.read(reinterpret_cast<char*>(&sequence), sizeof(sequence))) {
+            sequence = 0;
+        }
+        for (auto& fund : funds) {
+            if (!fund.getVolume().deserialize(in)) {
+                break;
+            }
+        }
+        in.close();
+
+        journal.advanceTo(sequence);
+        BankFunds& bank = funds[0];
+        for (const auto& record : journal.readAfter(sequence)) {
+            if (record.type == 'D') {
+                bank.recordDeposit(record.amount, record.timestamp);
+            }
+            else {
+                bank.recordWithdrawal(record.amount, record.timestamp);
+            }
+        }
+
+        std::cout << "Successfully loaded fund entries." << std::endl;
     }
 }
\ No newline at end of file
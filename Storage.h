@@ -1,7 +1,21 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <mutex>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 #include "Account.h"
+#include "AccountArena.h"
 #include "BankFunds.h"
+#include "Checkpointer.h"
+#include "Journal.h"
+#include "MappedFile.h"
+#include "NameTable.h"
+#include "PersistenceWorker.h"
+#include "QueryIndex.h"
 
 namespace bankSimulation {
 	/**
@@ -10,19 +24,243 @@ namespace bankSimulation {
 	 *
 	 * Provides functions for creating accounts, searching accounts, and saving/loading
 	 * accounts and bank funds from binary files.
+	 *
+	 * Checkpoints either run inline, on the thread whose transaction fills the journal,
+	 * or on a Checkpointer thread. A background checkpoint holds transactions off only
+	 * while it copies the accounts changed since the last one and seals the journal;
+	 * it writes the copies while transactions carry on.
 	 */
 	class Storage {
+	public:
+		/// Stable reference to a stored account: its position in the accounts container.
+		/// Unlike a pointer or reference, it stays valid when the container reallocates.
+		using AccountHandle = std::size_t;
+
+		/// Handle returned by lookups that find no account
+		static const AccountHandle noAccount = static_cast<AccountHandle>(-1);
+
+		/// Handles of the accounts sharing one last name, in creation order
+		using HandleList = std::pmr::vector<AccountHandle>;
+
 	private:
+		/// Directory holding accounts.dat, funds.dat and journal.dat; empty for the working directory
+		std::string dataDirectory;
+
+		/// Loaded histories and index nodes; declared before its users so it is destroyed after them
+		AccountArena accountArena;
+
 		/// Container holding all account objects in memory
 		std::vector<Account> accounts;
 
+		/// Account number to account handle
+		std::pmr::unordered_map<unsigned, AccountHandle> accountNumberIndex{ &accountArena };
+
+		/// Every distinct last name, stored once; accounts refer to theirs by id
+		NameTable lastNames;
+
+		/// Last name id to the handles of the accounts with that name
+		std::pmr::vector<HandleList> lastNameIndex{ &accountArena };
+
+		/// Balance, last transaction time and last name order, for findAccounts
+		QueryIndex queryIndex;
+
+		/// Guards queryIndex, which transactions on different accounts update concurrently
+		std::mutex queryIndexMutex;
+
 		/// Container holding bank funds data in memory
 		std::vector<BankFunds> funds;
 
 		/// Last assigned unique account number (auto-incrementing)
 		unsigned lastAccountNumber = 10'000;
 
+		/// Write-ahead log of transactions made since the last checkpoint
+		Journal journal;
+
+		/// Writes journal records off the transaction path; declared after journal so it drains first on destruction
+		PersistenceWorker persistence{ journal };
+
+		/// Number of journaled transactions that triggers an automatic checkpoint
+		std::size_t checkpointInterval = 500;
+
+		/// Whether a batch is running, in which case transactions are persisted once at its end; read by the Checkpointer
+		std::atomic<bool> batchActive{ false };
+
+		/// Whether loadAccount leaves transaction histories on disk until first use
+		bool lazyHistory = false;
+
+		/// Memory allowed for resident histories in lazy mode before eviction starts
+		std::size_t historyBudget = 64 * 1024 * 1024;
+
+		/// Threads that read a mapped accounts.dat; 0 for one per core
+		unsigned loadThreads = 0;
+
+		/// Memory held by resident histories in lazy mode, as last measured
+		std::size_t residentHistoryBytes = 0;
+
+		/// Resident histories in lazy mode, most recently used first
+		std::list<AccountHandle> historyLru;
+
+		/// Position of each resident history in historyLru and its measured size
+		std::unordered_map<AccountHandle, std::pair<std::list<AccountHandle>::iterator, std::size_t>> historyResidents;
+
+		/// Guards the lazy history bookkeeping when several threads use histories
+		std::mutex historyMutex;
+
+		/// accounts.dat, kept mapped in lazy mode so histories can be paged in
+		MappedFile accountsFile;
+
+		/// File offset of the heap in accountsFile
+		std::uint64_t accountsHeapOffset = 0;
+
+		/// Layout version of accountsFile, which decides how stored histories are read
+		std::uint32_t accountsVersion = 0;
+
+		/// Heap bytes in accounts.dat left behind by blocks that moved, reclaimed by compactAccounts
+		std::uint64_t accountsGarbage = 0;
+
+		/// Held shared by every transaction, and exclusively while a background checkpoint captures or publishes
+		std::shared_mutex stateMutex;
+
+		/// Serializes checkpoints, so a background one and checkpoint() never write the files at the same time
+		std::mutex checkpointMutex;
+
+		/// Accounts changed since the last background capture, possibly repeated; guarded by queryIndexMutex
+		std::vector<AccountHandle> changedAccounts;
+
+		/// Writes checkpoints in the background; declared last so it stops before the members it uses are destroyed
+		Checkpointer checkpointer{ *this };
+
+		/// Changed accounts and bank totals copied by a background checkpoint; defined in Storage.cpp
+		struct Snapshot;
+
+		/**
+		 * @brief Builds the path of a data file inside the data directory.
+		 * @param fileName Name of the data file.
+		 * @return Path to open.
+		 */
+		std::string dataPath(const char* fileName) const;
+
+		/**
+		 * @brief Chooses where new account histories are allocated.
+		 * @return The arena, or the heap in lazy history mode.
+		 */
+		std::pmr::memory_resource* historyResource();
+
+		/**
+		 * @brief Reads an account's stored history from the mapped accounts.dat.
+		 * @param account Account whose history is not loaded.
+		 * @return Transactions in chronological order, allocated from the account's history resource.
+		 */
+		Account::History readStoredHistory(const Account& account) const;
+
+		/**
+		 * @brief Waits for queued journal records and reports any the journal failed to write.
+		 * @return False if a record was lost, leaving the checkpoint being written as the only copy of its transaction.
+		 */
+		bool flushJournal();
+
+		/**
+		 * @brief Evicts least recently used clean histories until the budget is met.
+		 * @param keep Handle of a history that must stay resident.
+		 */
+		void evictHistories(AccountHandle keep);
+
+		/**
+		 * @brief Reads accounts from a version 1 stream.
+		 * @param in Stream positioned at the start of accounts.dat.
+		 * @return Last journal sequence number included in the file.
+		 */
+		std::uint64_t loadAccountsV1(std::istream& in);
+
+		/**
+		 * @brief Reads accounts from a memory-mapped version 2 to 4 file.
+		 * @param file Mapped accounts.dat.
+		 * @param accountSequences Receives the journal sequence each account is current to.
+		 * @return Last journal sequence number included in the file.
+		 */
+		std::uint64_t loadAccountsMapped(const MappedFile& file, std::vector<std::uint64_t>& accountSequences);
+
+		/**
+		 * @brief Writes only the changed accounts into the existing accounts.dat.
+		 * @return False if the file needs a full rewrite instead.
+		 */
+		bool updateAccountsInPlace();
+
+		/**
+		 * @brief Copies the changed accounts and the bank totals, then seals the journal.
+		 *
+		 * Runs with transactions held off.
+		 *
+		 * @param snapshot Receives the copies.
+		 * @return False if nothing changed since the last capture.
+		 */
+		bool captureSnapshot(Snapshot& snapshot);
+
+		/**
+		 * @brief Writes a snapshot's accounts into the existing accounts.dat.
+		 * @param snapshot Captured accounts.
+		 * @param historyOffsets Receives the history offset of each captured account.
+		 * @return False if the file needs a full rewrite instead.
+		 */
+		bool writeSnapshotInPlace(const Snapshot& snapshot, std::vector<std::uint64_t>& historyOffsets);
+
+		/**
+		 * @brief Rewrites accounts.dat from a snapshot and the blocks of the current file.
+		 * @param snapshot Captured accounts.
+		 * @param historyOffsets Receives the history offset of every account.
+		 * @return False if the current file cannot be copied from or the new one was not written.
+		 */
+		bool compactSnapshot(const Snapshot& snapshot, std::vector<std::uint64_t>& historyOffsets);
+
+		/**
+		 * @brief Writes fund records to "funds.dat" through a synced temporary file.
+		 * @param records Funds to write.
+		 * @param sequence Last journal record they include.
+		 * @return False if the file was not replaced.
+		 */
+		bool writeFunds(const std::vector<BankFunds>& records, std::uint64_t sequence);
+
+		/**
+		 * @brief Adds a stored account to the lookup indexes.
+		 * @param handle Handle of the account to index.
+		 */
+		void indexAccount(AccountHandle handle);
+
+		/**
+		 * @brief Rebuilds the lookup indexes from the accounts container.
+		 */
+		void rebuildIndexes();
+
+		/**
+		 * @brief Rebuilds the balance and last transaction time indexes from the accounts container.
+		 */
+		void rebuildQueryIndex();
+
+		/**
+		 * @brief Gets the time of an account's newest transaction, loaded or stored.
+		 *
+		 * Reads the mapped accounts.dat, so the caller holds stateMutex or runs before
+		 * the checkpointer starts.
+		 *
+		 * @param account Account stored in this Storage.
+		 * @return Seconds since the epoch, or QueryIndex::noActivity.
+		 */
+		std::int64_t lastActivityOf(const Account& account) const;
+
+		/**
+		 * @brief Gets the handle of an account from its address.
+		 * @param account Account to look up.
+		 * @return Handle, or noAccount if the account is not stored here.
+		 */
+		AccountHandle handleOf(const Account& account) const;
+
 	public:
+		/**
+		 * @brief Creates an empty storage whose data files live in the given directory.
+		 * @param directory Existing directory for the data files; empty for the working directory.
+		 */
+		explicit Storage(const std::string& directory = "");
+
 		/**
 		 * @brief Accesses the accounts container.
 		 * @return Reference to vector of Account objects.
@@ -35,6 +273,52 @@ namespace bankSimulation {
 		 */
 		std::vector<BankFunds>& getFunds();
 
+		/**
+		 * @brief Accesses a stored account through its handle.
+		 * @param handle Handle returned by a lookup.
+		 * @return Reference to the account.
+		 */
+		Account& getAccount(AccountHandle handle);
+
+		/**
+		 * @brief Accesses a stored account through its handle.
+		 * @param handle Handle returned by a lookup.
+		 * @return Const reference to the account.
+		 */
+		const Account& getAccount(AccountHandle handle) const;
+
+		/**
+		 * @brief Stores a fully initialized account and adds it to the indexes.
+		 *
+		 * Must not be called while other threads are running transactions; a background
+		 * checkpoint is held off.
+		 *
+		 * @param account Account to store.
+		 * @return Handle of the stored account.
+		 */
+		AccountHandle addAccount(Account&& account);
+
+		/**
+		 * @brief Finds an account by its unique account number in constant time.
+		 * @param accountNumber Account number to look up.
+		 * @return Handle of the account, or noAccount if none matches.
+		 */
+		AccountHandle findByAccountNumber(unsigned accountNumber) const;
+
+		/**
+		 * @brief Resolves a last name to its interned id without allocating.
+		 * @param lastName Last name to look up.
+		 * @return Id of the name, or NameTable::noName if no account has it.
+		 */
+		NameTable::NameId findLastNameId(std::string_view lastName) const;
+
+		/**
+		 * @brief Finds every account with the given last name in constant time.
+		 * @param lastNameId Id returned by findLastNameId.
+		 * @return Handles of matching accounts in creation order; empty for NameTable::noName.
+		 */
+		const HandleList& findByLastName(NameTable::NameId lastNameId) const;
+
 		/**
 		 * @brief Creates and adds a new account after user input and validation.
 		 *
@@ -49,33 +333,282 @@ namespace bankSimulation {
 		 * Prompts user to select search criteria, performs search, and displays
 		 * account balance and transaction history if a match is found.
 		 */
-		void searchAccounts() const;
+		void searchAccounts();
+
+		/**
+		 * @brief Finds accounts that pass every filter of a query.
+		 *
+		 * Walks whichever index fits the query best (last name order, last transaction
+		 * time, or balance) and checks the other filters on each account it meets, so a
+		 * selective query touches only the accounts near its answer. Histories are only
+		 * read for the withdrawal filter, only for accounts that pass the rest and whose
+		 * indexed withdrawal bound is large enough, and at most query.historyScanLimit of
+		 * them; they are never paged in, so a query does not evict resident histories.
+		 *
+		 * @param query Filters and result limit.
+		 * @return Handles of matching accounts, in the order of the index walked.
+		 */
+		std::vector<AccountHandle> findAccounts(const AccountQuery& query);
+
+		/**
+		 * @brief Prompts for query filters, runs findAccounts and prints the matches.
+		 */
+		void queryAccounts();
+
+		/**
+		 * @brief Gets the accounts with the largest balances.
+		 * @param count Most accounts to return.
+		 * @return Handles, largest balance first.
+		 */
+		std::vector<AccountHandle> largestAccounts(std::size_t count);
+
+		/**
+		 * @brief Gets the accounts with the smallest balances.
+		 * @param count Most accounts to return.
+		 * @return Handles, smallest balance first.
+		 */
+		std::vector<AccountHandle> smallestAccounts(std::size_t count);
+
+		/**
+		 * @brief Gets an account's place on the balance leaderboard.
+		 * @param handle Handle of a stored account.
+		 * @return 1 for the largest balance, or 0 if the handle is not indexed.
+		 */
+		std::size_t balanceRank(AccountHandle handle);
+
+		/**
+		 * @brief Prints the top or bottom of the balance leaderboard, or one account's rank.
+		 *
+		 * Every answer comes from the balance index kept up to date by each transaction,
+		 * so the report costs O(log n + N) however many accounts are stored.
+		 */
+		void balanceLeaderboard();
+
+		/**
+		 * @brief Moves an account within the query indexes after a transaction.
+		 *
+		 * Safe to call from several threads, each working on a different account.
+		 * Does nothing for accounts that are not stored in this Storage.
+		 *
+		 * @param account Account whose balance was just updated.
+		 * @param lastTransaction Time of the transaction.
+		 * @param withdrawn Amount withdrawn by the transaction, or 0 for a deposit.
+		 */
+		void updateQueryIndex(const Account& account, std::time_t lastTransaction, double withdrawn);
+
+		/**
+		 * @brief Enables or disables on-demand loading of transaction histories.
+		 *
+		 * When enabled, loadAccount reads only account headers and a history offset;
+		 * each history is paged in on first use and evicted under the memory budget.
+		 *
+		 * @param enabled True to defer history loading.
+		 * @param budgetBytes Memory allowed for resident histories.
+		 */
+		void setLazyHistory(bool enabled, std::size_t budgetBytes);
+
+		/**
+		 * @brief Sets how many threads loadAccount uses to read a mapped accounts.dat.
+		 *
+		 * Small books are read on the calling thread whatever the setting.
+		 *
+		 * @param threads Thread count; 0 for one per core.
+		 */
+		void setLoadThreads(unsigned threads);
+
+		/**
+		 * @brief Makes sure an account's transaction history is in memory.
+		 *
+		 * Must be called before reading or appending to the history of an account.
+		 * Safe to call from several threads, each working on a different account. An
+		 * account that is not stored in this Storage is loaded if needed but never
+		 * counted against the lazy history budget or evicted.
+		 *
+		 * @param account Account stored in this Storage, or one the caller keeps itself.
+		 * @param forUpdate True if the caller will append to the history; keeps it from
+		 *                  being evicted until the next checkpoint.
+		 */
+		void loadHistory(Account& account, bool forUpdate = false);
+
+		/**
+		 * @brief Appends a completed transaction to the journal.
+		 *
+		 * Called by Account::logTransaction once the account and bank totals are updated.
+		 * The record goes through the PersistenceWorker, so whether this waits for the write
+		 * depends on the durability mode. Triggers a checkpoint when enough records have
+		 * accumulated, or when the record could not be written, so the transaction reaches
+		 * the data files instead.
+		 *
+		 * @param accountNumber Account the transaction was applied to.
+		 * @param type Type of transaction.
+		 * @param amount Amount of the transaction.
+		 * @param resultingBalance Account balance after the transaction.
+		 * @param when Time the transaction happened.
+		 */
+		void journalTransaction(unsigned accountNumber, Account::TransactionType type, double amount,
+			double resultingBalance, std::time_t when);
+
+		/**
+		 * @brief Writes accounts.dat and funds.dat, then empties the journal.
+		 *
+		 * Runs on the calling thread, which must be the only one running transactions.
+		 * Waits for a background checkpoint in progress. Transactions the journal failed
+		 * to write are still in memory, so the checkpoint stores them; if it cannot, they
+		 * stay in memory only and this is reported.
+		 *
+		 * @return False if accounts.dat or funds.dat could not be written; the journal is then kept.
+		 */
+		bool checkpoint();
+
+		/**
+		 * @brief Takes the lock every transaction holds while it changes accounts and totals.
+		 *
+		 * Shared between transactions, so they only exclude a background checkpoint
+		 * while it captures or publishes its snapshot.
+		 *
+		 * @return Shared lock, released when it goes out of scope.
+		 */
+		std::shared_lock<std::shared_mutex> lockForTransaction();
+
+		/**
+		 * @brief Writes a checkpoint without stopping transactions for longer than a copy.
+		 *
+		 * Called by the Checkpointer thread. With transactions held off, copies the
+		 * accounts changed since the last capture and the bank totals, and seals the
+		 * journal. Then writes the copies into accounts.dat in place (or compacts it from
+		 * the current file) and funds.dat, and only then deletes the sealed journal. The
+		 * first checkpoint of a file that is not in the current layout is written with
+		 * transactions held off throughout.
+		 *
+		 * @param report Receives the duration, the pause, and the bytes reclaimed.
+		 * @return False if nothing had changed, a batch is running, or the accounts could not be written.
+		 */
+		bool backgroundCheckpoint(CheckpointReport& report);
+
+		/**
+		 * @brief Moves checkpoints to a background thread, or back inline.
+		 *
+		 * With a period, a Checkpointer writes a checkpoint at least that often, and
+		 * whenever the journal reaches the checkpoint interval; transactions no longer
+		 * checkpoint inline. Zero stops the thread after its current checkpoint.
+		 *
+		 * @param period Longest time between background checkpoints; zero for inline checkpoints.
+		 */
+		void setCheckpointPeriod(std::chrono::milliseconds period);
+
+		/**
+		 * @brief Gets what the background checkpoints have done so far.
+		 * @param last Receives the report of the most recent one.
+		 * @param totals Receives the sum of every report.
+		 * @return Number of background checkpoints written.
+		 */
+		std::uint64_t getCheckpointReports(CheckpointReport& last, CheckpointReport& totals);
+
+		/**
+		 * @brief Starts a batch: transactions are no longer journaled one by one.
+		 *
+		 * The batch input itself is the record of what happened, so it can be applied
+		 * again if the process stops before endBatch. Background checkpoints are skipped
+		 * until then, so the data files never hold part of a batch.
+		 */
+		void beginBatch();
+
+		/**
+		 * @brief Ends a batch and persists everything it changed with one checkpoint.
+		 *
+		 * The batch stays active until the checkpoint is written, so a background
+		 * checkpoint cannot write the batch's accounts ahead of it.
+		 */
+		void endBatch();
+
+		/**
+		 * @brief Checks whether a batch is running.
+		 * @return True between beginBatch and the end of endBatch.
+		 */
+		bool isBatchActive() const;
+
+		/**
+		 * @brief Checks whether checkpoints run on the Checkpointer thread rather than inline.
+		 * @return True while a checkpoint period is set.
+		 */
+		bool isCheckpointerRunning() const;
+
+		/**
+		 * @brief Chooses when a transaction may report success relative to its journal write.
+		 *
+		 * Sync writes and syncs each record on the calling thread. GroupCommit hands it
+		 * to the persistence thread and waits for the fsync of the batch it joined. Async
+		 * hands it over and returns; queued records are written by the next checkpoint or
+		 * when the Storage is destroyed.
+		 *
+		 * @param mode New durability mode.
+		 */
+		void setDurability(PersistenceWorker::Durability mode);
+
+		/**
+		 * @brief Gets the current durability mode.
+		 * @return Mode in effect.
+		 */
+		PersistenceWorker::Durability getDurability() const;
+
+		/**
+		 * @brief Sets the group commit window and batch size of the persistence thread.
+		 *
+		 * @param window How long the thread waits for more records before an fsync.
+		 * @param maxBatch Most records made durable by one fsync.
+		 */
+		void setGroupCommit(std::chrono::microseconds window, std::size_t maxBatch);
+
+		/**
+		 * @brief Sets how many journaled transactions trigger an automatic checkpoint.
+		 * @param interval Record count; values below 1 are treated as 1.
+		 */
+		void setCheckpointInterval(std::size_t interval);
 
 		/**
 		 * @brief Saves all account data to a binary file ("accounts.dat").
 		 *
-		 * Writes the number of accounts, each serialized Account object,
-		 * and the last used account number for continuity.
+		 * Writes only the accounts changed since the last save, in place, when the file
+		 * allows it; otherwise rewrites it with compactAccounts.
+		 *
+		 * @return False if the file could not be written either way.
 		 */
-		void saveAccount();
+		bool saveAccount();
+
+		/**
+		 * @brief Rewrites accounts.dat from scratch, reclaiming space left by moved blocks.
+		 *
+		 * Writes the version 4 layout (a header, a record table with spare slots, and a
+		 * heap of history extents, names and passwords) to a new file, syncs it, and
+		 * renames it over the old one, so a crash leaves either the old or the new book.
+		 *
+		 * @return False if the new file could not be written; the old one is left in place.
+		 */
+		bool compactAccounts();
 
 		/**
 		 * @brief Loads account data from a binary file ("accounts.dat").
 		 *
-		 * Creates the file with defaults if missing, then reads account count,
-		 * deserializes accounts, and restores last assigned account number.
+		 * Creates the file with defaults if missing. Detects the layout version, memory
+		 * maps version 2 to 4 files, still reads version 1 files, and replays journaled
+		 * transactions newer than the file.
 		 */
 		void loadAccount();
 
 		/**
 		 * @brief Saves all bank fund records to a binary file ("funds.dat").
+		 *
+		 * Also records the last journal sequence number included.
+		 *
+		 * @return False if the file could not be written; the old one is left in place.
 		 */
-		void saveBank();
+		bool saveBank();
 
 		/**
 		 * @brief Loads bank fund records from a binary file ("funds.dat").
 		 *
 		 * If file is missing or invalid, creates a new default funds file.
+		 * Otherwise replays journaled transactions newer than the file into the totals.
 		 */
 		void loadBank();
 	};
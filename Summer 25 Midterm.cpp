@@ -1,21 +1,197 @@
 #include "Account.h"
 #include "BankFunds.h"
+#include "Batch.h"
+#include "Benchmark.h"
+#include "DatasetGenerator.h"
 #include "menus.h"
+#include "Metrics.h"
+#include "ShardedCounter.h"
 #include "Storage.h"
+#include "Trace.h"
+#include "TransactionEngine.h"
 #include "Validators.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <thread>
 
 using namespace bankSimulation;
 
-int main()
+int main(int argc, char* argv[])
 {
+    //"--stress [threads] [operations]" checks the concurrent engine on a private book in stress-data
+    if (argc > 1 && std::string(argv[1]) == "--stress") {
+        unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+        std::size_t operations = argc > 3 ? static_cast<std::size_t>(std::atoll(argv[3])) : 2'000'000;
+        return runStressTest(threads > 0 ? threads : 4, operations, "stress-data") ? 0 : 1;
+    }
+
+    //"--batch-check [accounts] [records]" stops a batch halfway, applies it again, and checks nothing was applied twice
+    if (argc > 1 && std::string(argv[1]) == "--batch-check") {
+        std::size_t accounts = argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 10'000;
+        std::size_t records = argc > 3 ? static_cast<std::size_t>(std::atoll(argv[3])) : 200'000;
+        return runBatchRecoveryCheck(accounts > 0 ? accounts : 10'000, records, "batch-check-data") ? 0 : 1;
+    }
+
+    //"--bench-counters [max threads] [operations per thread]" compares sharded totals with a single atomic
+    if (argc > 1 && std::string(argv[1]) == "--bench-counters") {
+        unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : std::thread::hardware_concurrency();
+        std::size_t operations = argc > 3 ? static_cast<std::size_t>(std::atoll(argv[3])) : 10'000'000;
+        runCounterBenchmark(threads > 0 ? threads : 4, operations);
+        return 0;
+    }
+
+    //"--bench-commit [max threads] [records per thread] [batch]" shows group commit throughput against latency
+    if (argc > 1 && std::string(argv[1]) == "--bench-commit") {
+        unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 16;
+        std::size_t records = argc > 3 ? static_cast<std::size_t>(std::atoll(argv[3])) : 500;
+        std::size_t batch = argc > 4 ? static_cast<std::size_t>(std::atoll(argv[4])) : 256;
+        runCommitBenchmark("commit-bench.dat", threads > 0 ? threads : 16, records > 0 ? records : 500, batch);
+        return 0;
+    }
+
+    //"--generate <accounts> [--seed N] [--last-names N] [--skew S] [--mean-history N] [--legacy] [--dir path]"
+    //writes a synthetic accounts.dat and funds.dat for load testing
+    if (argc > 2 && std::string(argv[1]) == "--generate") {
+        DatasetOptions options;
+        options.accounts = static_cast<std::size_t>(std::atoll(argv[2]));
+        for (int i = 3; i < argc; ++i) {
+            std::string option = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (option == "--legacy") {
+                options.legacyFormat = true;
+            }
+            else if (option == "--seed" && hasValue) {
+                options.seed = static_cast<unsigned>(std::atoll(argv[++i]));
+            }
+            else if (option == "--last-names" && hasValue) {
+                options.lastNames = static_cast<std::size_t>(std::atoll(argv[++i]));
+            }
+            else if (option == "--skew" && hasValue) {
+                options.lastNameSkew = std::atof(argv[++i]);
+            }
+            else if (option == "--mean-history" && hasValue) {
+                options.meanHistory = std::atof(argv[++i]);
+            }
+            else if (option == "--dir" && hasValue) {
+                options.directory = argv[++i];
+            }
+            else {
+                std::cerr << "Unknown generator option " << option << "." << std::endl;
+                return 1;
+            }
+        }
+        return generateDataset(options) ? 0 : 1;
+    }
+
+    //"--bench [max accounts] [results.csv]" times the core paths on scratch data in "bench-data"
+    if (argc > 1 && std::string(argv[1]) == "--bench") {
+        std::size_t maxAccounts = argc > 2 ? static_cast<std::size_t>(std::atoll(argv[2])) : 1'000'000;
+        if (argc > 3) {
+            std::ofstream results(argv[3]);
+            if (!results) {
+                std::cerr << "Cannot write " << argv[3] << "." << std::endl;
+                return 1;
+            }
+            return runBenchmarks(maxAccounts, "bench-data", results) ? 0 : 1;
+        }
+        return runBenchmarks(maxAccounts, "bench-data", std::cout) ? 0 : 1;
+    }
+
     //storage instantiation
     Storage storage;
+
+    //"--lazy-history [MB]" loads transaction histories on first use, within a memory budget
+    //"--load-threads <n>" reads accounts.dat with n threads at startup; 0 (the default) uses one per core
+    //"--batch <file>" applies a transaction file without the menus
+    //"--no-metrics" turns off the latency histograms and counters written to metrics.txt on exit
+    //"--trace <file>" writes startup, save/load and menu phases as a Chrome/Perfetto trace on exit
+    //"--durability sync|group|async" chooses when a transaction returns relative to its journal write
+    //"--commit-window <microseconds>" and "--commit-batch <records>" tune how group commit batches fsyncs
+    //"--checkpoint-seconds <n>" writes checkpoints from a background thread at least every n seconds; 0 writes them inline
+    std::string batchPath;
+    std::string tracePath;
+    bool collectMetrics = true;
+    PersistenceWorker::Durability durability = PersistenceWorker::Durability::GroupCommit;
+    long long commitWindow = 0;
+    std::size_t commitBatch = 256;
+    long long checkpointSeconds = 30;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--batch" && i + 1 < argc) {
+            batchPath = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--trace" && i + 1 < argc) {
+            tracePath = argv[++i];
+        }
+        else if (std::string(argv[i]) == "--no-metrics") {
+            collectMetrics = false;
+        }
+        else if (std::string(argv[i]) == "--durability" && i + 1 < argc) {
+            std::string mode = argv[++i];
+            if (mode == "sync") {
+                durability = PersistenceWorker::Durability::Sync;
+            }
+            else if (mode == "async") {
+                durability = PersistenceWorker::Durability::Async;
+            }
+            else if (mode != "group") {
+                std::cerr << "Unknown durability mode " << mode << "; using group." << std::endl;
+            }
+        }
+        else if (std::string(argv[i]) == "--commit-window" && i + 1 < argc) {
+            commitWindow = std::atoll(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--commit-batch" && i + 1 < argc) {
+            commitBatch = static_cast<std::size_t>(std::atoll(argv[++i]));
+        }
+        else if (std::string(argv[i]) == "--checkpoint-seconds" && i + 1 < argc) {
+            checkpointSeconds = std::atoll(argv[++i]);
+        }
+        else if (std::string(argv[i]) == "--load-threads" && i + 1 < argc) {
+            storage.setLoadThreads(static_cast<unsigned>(std::atoi(argv[++i])));
+        }
+        else if (std::string(argv[i]) == "--lazy-history") {
+            std::size_t budgetMegabytes = 64;
+            if (i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+                budgetMegabytes = static_cast<std::size_t>(std::atoi(argv[++i]));
+            }
+            storage.setLazyHistory(true, budgetMegabytes * 1024 * 1024);
+        }
+    }
+
+    metrics::setEnabled(collectMetrics);
+    storage.setGroupCommit(std::chrono::microseconds(commitWindow), commitBatch);
+    storage.setDurability(durability);
+    if (!tracePath.empty()) {
+        trace::start(tracePath);
+    }
+
     //load from relevent .dat files.
     storage.loadBank();
     storage.loadAccount();
-    //login menus for clients/employee branching
-    branchMenu(storage);
+    storage.setCheckpointPeriod(std::chrono::seconds(checkpointSeconds));
+
+    if (!batchPath.empty()) {
+        BatchReport report;
+        if (!runBatch(storage, batchPath, report)) {
+            trace::stop();
+            return 1;
+        }
+        printBatchReport(report);
+    }
+    else {
+        //login menus for clients/employee branching
+        branchMenu(storage);
+    }
+
+    if (collectMetrics) {
+        metrics::dumpToFile("metrics.txt");
+    }
+    if (!tracePath.empty() && trace::stop()) {
+        std::cout << "Trace written to " << tracePath << "." << std::endl;
+    }
     
     return 0;
 }
@@ -0,0 +1,140 @@
+#include "Trace.h"
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace bankSimulation {
+    namespace trace {
+        std::atomic<bool> enabled{ false };
+
+        namespace {
+            /**
+             * @struct Event
+             * @brief One completed trace event.
+             */
+            struct Event {
+                const char* name;               ///< Event name
+                const char* category;           ///< Event category
+                std::int64_t startNanoseconds;  ///< Start, relative to the start of the trace
+                std::int64_t durationNanoseconds; ///< Length of the event
+                unsigned threadId;              ///< Small id of the recording thread
+            };
+
+            std::mutex eventsMutex;                         ///< Guards every variable below
+            std::vector<Event> events;                      ///< Events kept so far
+            std::size_t eventLimit = 0;                     ///< Events kept before dropping
+            std::size_t droppedEvents = 0;                  ///< Events dropped past the limit
+            std::string tracePath;                          ///< File written by stop()
+            std::chrono::steady_clock::time_point origin;   ///< Time zero of the trace
+
+            /**
+             * @brief Gets a small, stable id for the calling thread.
+             * @return 1 for the first thread that records an event, 2 for the next, and so on.
+             */
+            unsigned currentThreadId() {
+                static std::atomic<unsigned> nextId{ 1 };
+                thread_local unsigned id = nextId.fetch_add(1, std::memory_order_relaxed);
+                return id;
+            }
+
+            /**
+             * @brief Writes a nanosecond count as the microseconds the trace format expects.
+             * @param out Stream to write to.
+             * @param nanoseconds Value to write.
+             */
+            void writeMicroseconds(std::ostream& out, std::int64_t nanoseconds) {
+                out << nanoseconds / 1'000 << "." << std::setw(3) << std::setfill('0') << nanoseconds % 1'000
+                    << std::setfill(' ');
+            }
+        }
+
+        /**
+         * @brief Starts recording events for a trace file.
+         *
+         * Event times are measured from this call.
+         *
+         * @param path File written by stop().
+         * @param maxEvents Events kept before further ones are dropped and only counted.
+         */
+        void start(const std::string& path, std::size_t maxEvents) {
+            std::lock_guard<std::mutex> lock(eventsMutex);
+            events.clear();
+            eventLimit = maxEvents;
+            droppedEvents = 0;
+            tracePath = path;
+            origin = std::chrono::steady_clock::now();
+            enabled.store(true, std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Records one completed event, or counts it if the event limit is reached.
+         *
+         * @param name Event name.
+         * @param category Event category.
+         * @param start When the event began.
+         * @param end When the event ended.
+         */
+        void record(const char* name, const char* category,
+            std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+            unsigned threadId = currentThreadId();
+
+            std::lock_guard<std::mutex> lock(eventsMutex);
+            if (!isEnabled()) {
+                return;
+            }
+            if (events.size() >= eventLimit) {
+                ++droppedEvents;
+                return;
+            }
+
+            Event event;
+            event.name = name;
+            event.category = category;
+            event.startNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(start - origin).count();
+            event.durationNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            event.threadId = threadId;
+            events.push_back(event);
+        }
+
+        /**
+         * @brief Stops recording and writes the trace file.
+         *
+         * Events are written as complete ("X") events. If any were dropped, a metadata
+         * entry records how many, so a truncated trace is never mistaken for a full one.
+         *
+         * @return False if tracing was not started or the file could not be written.
+         */
+        bool stop() {
+            std::lock_guard<std::mutex> lock(eventsMutex);
+            if (!isEnabled()) {
+                return false;
+            }
+            enabled.store(false, std::memory_order_relaxed);
+
+            std::ofstream out(tracePath, std::ios::trunc);
+            if (!out) {
+                std::cerr << "Error opening " << tracePath << " for writing." << std::endl;
+                return false;
+            }
+
+            out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"droppedEvents\":" << droppedEvents << "},\n";
+            out << "\"traceEvents\":[\n";
+            out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Laney Bank\"}}";
+            for (const auto& event : events) {
+                out << ",\n{\"name\":\"" << event.name << "\",\"cat\":\"" << event.category
+                    << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.threadId << ",\"ts\":";
+                writeMicroseconds(out, event.startNanoseconds);
+                out << ",\"dur\":";
+                writeMicroseconds(out, event.durationNanoseconds);
+                out << "}";
+            }
+            out << "\n]}\n";
+
+            std::vector<Event>().swap(events);
+            return static_cast<bool>(out);
+        }
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace bankSimulation {
+
+	/**
+	 * @brief Scoped trace events written as a Chrome/Perfetto trace ("traceEvents" JSON).
+	 *
+	 * Tracing is off until start() is called. Events are kept in memory and written by
+	 * stop(), so recording never touches the disk. The resulting file opens in
+	 * chrome://tracing or ui.perfetto.dev.
+	 */
+	namespace trace {
+
+		/// Whether TraceScope records events
+		extern std::atomic<bool> enabled;
+
+		/**
+		 * @brief Checks whether events are being recorded.
+		 * @return True between start() and stop().
+		 */
+		inline bool isEnabled() {
+			return enabled.load(std::memory_order_relaxed);
+		}
+
+		/**
+		 * @brief Starts recording events for a trace file.
+		 *
+		 * @param path File written by stop().
+		 * @param maxEvents Events kept before further ones are dropped and only counted.
+		 */
+		void start(const std::string& path, std::size_t maxEvents = 1'000'000);
+
+		/**
+		 * @brief Stops recording and writes every kept event to the trace file.
+		 * @return False if tracing was not started or the file could not be written.
+		 */
+		bool stop();
+
+		/**
+		 * @brief Records one completed event.
+		 *
+		 * @param name Event name; must outlive the trace, such as a string literal.
+		 * @param category Event category; must outlive the trace.
+		 * @param start When the event began.
+		 * @param end When the event ended.
+		 */
+		void record(const char* name, const char* category,
+			std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end);
+	}
+
+	/**
+	 * @class TraceScope
+	 * @brief Records the lifetime of a scope as one trace event.
+	 *
+	 * Checks whether tracing is enabled once, on construction, and does nothing else
+	 * when it is not.
+	 */
+	class TraceScope {
+	private:
+		const char* name;                                  ///< Event name
+		const char* category;                              ///< Event category
+		bool active;                                       ///< Whether this scope records
+		std::chrono::steady_clock::time_point start;       ///< When the scope was entered
+
+	public:
+		/**
+		 * @brief Opens a trace event.
+		 *
+		 * @param name Event name; must be a string literal or otherwise outlive the trace.
+		 * @param category Event category, used to filter events in the viewer.
+		 */
+		explicit TraceScope(const char* name, const char* category = "bank")
+			: name(name), category(category), active(trace::isEnabled()) {
+			if (active) {
+				start = std::chrono::steady_clock::now();
+			}
+		}
+
+		/**
+		 * @brief Closes the event and records it.
+		 */
+		~TraceScope() {
+			if (active) {
+				trace::record(name, category, start, std::chrono::steady_clock::now());
+			}
+		}
+
+		TraceScope(const TraceScope&) = delete;
+		TraceScope& operator=(const TraceScope&) = delete;
+	};
+}
@@ -0,0 +1,252 @@
+#include "TransactionEngine.h"
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace bankSimulation {
+
+    /**
+     * @brief Creates an engine over loaded storage.
+     *
+     * A worker reaching the checkpoint interval would otherwise write the checkpoint
+     * itself while other workers change accounts, so inline checkpoints are moved to the
+     * Checkpointer thread. Inside a batch nothing is checkpointed until it ends, so the
+     * caller's settings are left alone.
+     *
+     * @param storage Storage holding the accounts and at least one BankFunds entry.
+     */
+    TransactionEngine::TransactionEngine(Storage& storage)
+        : storage(storage), bank(storage.getFunds()[0]) {
+        if (!storage.isBatchActive() && !storage.isCheckpointerRunning()) {
+            storage.setCheckpointPeriod(checkpointPeriod);
+        }
+    }
+
+    /**
+     * @brief Picks the lock stripe that guards an account.
+     *
+     * Account numbers are handed out sequentially, so a plain modulo spreads them evenly.
+     *
+     * @param accountNumber Account to lock.
+     * @return Mutex of the account's stripe.
+     */
+    std::mutex& TransactionEngine::stripeFor(unsigned accountNumber) {
+        return stripes[accountNumber % stripeCount].lock;
+    }
+
+    /**
+     * @brief Deposits into an account under its stripe lock.
+     *
+     * @param accountNumber Target account.
+     * @param amount Amount to deposit.
+     * @return Outcome of the deposit.
+     */
+    Account::TransactionResult TransactionEngine::deposit(unsigned accountNumber, double amount) {
+        Storage::AccountHandle handle = storage.findByAccountNumber(accountNumber);
+        if (handle == Storage::noAccount) {
+            return Account::TransactionResult::UnknownAccount;
+        }
+
+        std::lock_guard<std::mutex> lock(stripeFor(accountNumber));
+        return storage.getAccount(handle).applyDeposit(amount, bank, storage);
+    }
+
+    /**
+     * @brief Withdraws from an account under its stripe lock.
+     *
+     * The balance check and the debit happen under the same lock, so two concurrent
+     * withdrawals can never overdraw the account.
+     *
+     * @param accountNumber Target account.
+     * @param amount Amount to withdraw.
+     * @return Outcome of the withdrawal.
+     */
+    Account::TransactionResult TransactionEngine::withdraw(unsigned accountNumber, double amount) {
+        Storage::AccountHandle handle = storage.findByAccountNumber(accountNumber);
+        if (handle == Storage::noAccount) {
+            return Account::TransactionResult::UnknownAccount;
+        }
+
+        std::lock_guard<std::mutex> lock(stripeFor(accountNumber));
+        return storage.getAccount(handle).applyWithdrawal(amount, bank, storage);
+    }
+
+    /**
+     * @brief Reads an account balance under its stripe lock.
+     *
+     * @param accountNumber Account to read.
+     * @return Current balance, or 0 if the account does not exist.
+     */
+    double TransactionEngine::getBalance(unsigned accountNumber) {
+        Storage::AccountHandle handle = storage.findByAccountNumber(accountNumber);
+        if (handle == Storage::noAccount) {
+            return 0.0;
+        }
+
+        std::lock_guard<std::mutex> lock(stripeFor(accountNumber));
+        return storage.getAccount(handle).getBalance();
+    }
+
+    /**
+     * @brief Runs concurrent random transactions and checks that every total reconciles.
+     *
+     * Uses a small set of accounts so that workers collide on the same accounts and
+     * stripes often. Amounts are whole cents, and the per-worker counts are kept in
+     * cents, so the comparison is exact.
+     *
+     * @param threadCount Number of worker threads.
+     * @param operationCount Total number of transactions across all workers.
+     * @param directory Scratch directory for the data files; created if missing.
+     * @return True if every total reconciled.
+     */
+    bool runStressTest(unsigned threadCount, std::size_t operationCount, const std::string& directory) {
+        const unsigned accountCount = 1'000;
+        const unsigned firstAccount = 10'000;
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        if (error) {
+            std::cerr << "Cannot create stress test directory " << directory << ": " << error.message() << std::endl;
+            return false;
+        }
+        for (const char* name : { "accounts.dat", "accounts.dat.tmp", "funds.dat", "funds.dat.tmp", "journal.dat", "journal.dat.sealed" }) {
+            std::filesystem::remove(std::filesystem::path(directory) / name, error);
+        }
+
+        Storage storage(directory);
+        storage.getFunds().push_back(BankFunds());
+        storage.beginBatch();
+
+        for (unsigned i = 0; i < accountCount; ++i) {
+            Account account;
+            account.setHolderFirstName("Stress");
+            account.setHolderLastName("Test");
+            account.setHolderAccountNumber(firstAccount + i);
+            account.setHolderPassword("Stress#1");
+            account.setBalance(0.0);
+            storage.addAccount(std::move(account));
+        }
+
+        const BankFunds& bank = storage.getFunds()[0];
+        std::int64_t startingHoldings = std::llround(bank.getTotalHoldings() * 100.0);
+
+        TransactionEngine engine(storage);
+
+        // Cents moved and outcomes seen by each worker
+        struct WorkerTally {
+            std::int64_t deposited = 0;
+            std::int64_t withdrawn = 0;
+            std::size_t insufficient = 0;
+        };
+        std::vector<WorkerTally> tallies(threadCount);
+        std::vector<std::thread> workers;
+
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned t = 0; t < threadCount; ++t) {
+            std::size_t share = operationCount / threadCount + (t < operationCount % threadCount ? 1 : 0);
+            workers.emplace_back([&engine, &tallies, t, share, accountCount, firstAccount]() {
+                std::mt19937 random(t + 1);
+                std::uniform_int_distribution<unsigned> pickAccount(0, accountCount - 1);
+                std::uniform_int_distribution<int> pickCents(1, 50'000);
+                WorkerTally& tally = tallies[t];
+
+                for (std::size_t i = 0; i < share; ++i) {
+                    unsigned accountNumber = firstAccount + pickAccount(random);
+                    int cents = pickCents(random);
+                    double amount = cents / 100.0;
+
+                    if (random() % 2 == 0) {
+                        if (engine.deposit(accountNumber, amount) == Account::TransactionResult::Applied) {
+                            tally.deposited += cents;
+                        }
+                    }
+                    else {
+                        Account::TransactionResult result = engine.withdraw(accountNumber, amount);
+                        if (result == Account::TransactionResult::Applied) {
+                            tally.withdrawn += cents;
+                        }
+                        else if (result == Account::TransactionResult::InsufficientFunds) {
+                            ++tally.insufficient;
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        WorkerTally expected;
+        for (const auto& tally : tallies) {
+            expected.deposited += tally.deposited;
+            expected.withdrawn += tally.withdrawn;
+            expected.insufficient += tally.insufficient;
+        }
+
+        std::int64_t balanceSum = 0;
+        bool overdrawn = false;
+        for (unsigned i = 0; i < accountCount; ++i) {
+            double balance = engine.getBalance(firstAccount + i);
+            balanceSum += std::llround(balance * 100.0);
+            overdrawn = overdrawn || balance < 0.0;
+        }
+
+        std::int64_t deposits = std::llround(bank.getTotalDeposits() * 100.0);
+        std::int64_t withdrawals = std::llround(bank.getTotalWithdrawals() * 100.0);
+        std::int64_t holdings = std::llround(bank.getTotalHoldings() * 100.0);
+
+        // The run fits in two days, so the last two daily buckets hold all of it
+        std::int64_t depositVolume = 0;
+        std::int64_t withdrawalVolume = 0;
+        for (const auto& bucket : bank.getVolume().recent(VolumeRollup::Resolution::Day, 2, std::time(nullptr))) {
+            depositVolume += bucket.depositCents;
+            withdrawalVolume += bucket.withdrawalCents;
+        }
+
+        // The workers are done, so the batch can be written in one checkpoint and read back
+        storage.endBatch();
+        Storage reloaded(directory);
+        reloaded.loadBank();
+        reloaded.loadAccount();
+        std::int64_t reloadedSum = 0;
+        for (const auto& acc : reloaded.getAccounts()) {
+            reloadedSum += std::llround(acc.getBalance() * 100.0);
+        }
+        bool persisted = reloaded.getAccounts().size() == accountCount
+            && !reloaded.getFunds().empty()
+            && std::llround(reloaded.getFunds()[0].getTotalDeposits() * 100.0) == deposits
+            && std::llround(reloaded.getFunds()[0].getTotalWithdrawals() * 100.0) == withdrawals
+            && reloadedSum == balanceSum;
+
+        bool passed = deposits == expected.deposited
+            && withdrawals == expected.withdrawn
+            && holdings - startingHoldings == expected.deposited - expected.withdrawn
+            && balanceSum == expected.deposited - expected.withdrawn
+            && depositVolume == expected.deposited
+            && withdrawalVolume == expected.withdrawn
+            && !overdrawn
+            && persisted;
+
+        std::cout << "--- Stress Test ---" << std::endl;
+        std::cout << "Threads: " << threadCount << ", operations: " << operationCount
+            << ", accounts: " << accountCount << std::endl;
+        std::cout << "Insufficient funds: " << expected.insufficient << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << "Deposits: $" << deposits / 100.0 << " (expected $" << expected.deposited / 100.0 << ")" << std::endl;
+        std::cout << "Withdrawals: $" << withdrawals / 100.0 << " (expected $" << expected.withdrawn / 100.0 << ")" << std::endl;
+        std::cout << "Sum of balances: $" << balanceSum / 100.0 << " (after reload $" << reloadedSum / 100.0 << ")" << std::endl;
+        std::cout << std::setprecision(3) << "Elapsed: " << seconds << " s" << std::endl;
+        std::cout << std::setprecision(0) << "Throughput: " << operationCount / seconds << " transactions/s" << std::endl;
+        std::cout << (passed ? "Totals reconcile." : "Totals DO NOT reconcile.") << std::endl;
+
+        return passed;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include "Account.h"
+#include "BankFunds.h"
+#include "Storage.h"
+
+namespace bankSimulation {
+
+	/**
+	 * @class TransactionEngine
+	 * @brief Applies deposits and withdrawals from many threads at once.
+	 *
+	 * Each account is guarded by one of a fixed set of striped mutexes chosen by its
+	 * account number, so transactions on different accounts rarely wait for each other
+	 * while two transactions on the same account never interleave. Bank totals are
+	 * updated through BankFunds' atomic recordDeposit/recordWithdrawal.
+	 *
+	 * Accounts must not be added or loaded while the engine is in use. Every transaction
+	 * is journaled through Storage like any other, in whichever persistence mode it is
+	 * set to. A checkpoint written inline would save accounts other workers are changing,
+	 * so the engine needs checkpoints on the Checkpointer thread, which captures them with
+	 * transactions held off. A caller that wants the work persisted once at the end
+	 * instead runs the engine inside its own Storage::beginBatch / endBatch.
+	 */
+	class TransactionEngine {
+	public:
+		/// Number of lock stripes shared by all accounts
+		static const std::size_t stripeCount = 64;
+
+		/// Checkpoint period set when the engine finds checkpoints running inline
+		static constexpr std::chrono::seconds checkpointPeriod{ 5 };
+
+	private:
+		/**
+		 * @struct Stripe
+		 * @brief One mutex on its own cache line, so neighbouring stripes do not contend.
+		 */
+		struct alignas(64) Stripe {
+			std::mutex lock;
+		};
+
+		Storage& storage;                 ///< Storage holding the accounts
+		BankFunds& bank;                  ///< Bank totals updated by every transaction
+		Stripe stripes[stripeCount];      ///< Per-account locks, selected by account number
+
+		/**
+		 * @brief Picks the lock stripe that guards an account.
+		 * @param accountNumber Account to lock.
+		 * @return Mutex of the account's stripe.
+		 */
+		std::mutex& stripeFor(unsigned accountNumber);
+
+	public:
+		/**
+		 * @brief Creates an engine over loaded storage.
+		 *
+		 * Outside a batch, starts the Checkpointer with checkpointPeriod if checkpoints
+		 * were running inline.
+		 *
+		 * @param storage Storage holding the accounts; its first BankFunds entry is updated.
+		 */
+		explicit TransactionEngine(Storage& storage);
+
+		TransactionEngine(const TransactionEngine&) = delete;
+		TransactionEngine& operator=(const TransactionEngine&) = delete;
+
+		/**
+		 * @brief Deposits into an account. Safe to call from any thread.
+		 *
+		 * @param accountNumber Target account.
+		 * @param amount Amount to deposit.
+		 * @return Applied, InvalidAmount, or UnknownAccount.
+		 */
+		Account::TransactionResult deposit(unsigned accountNumber, double amount);
+
+		/**
+		 * @brief Withdraws from an account. Safe to call from any thread.
+		 *
+		 * @param accountNumber Target account.
+		 * @param amount Amount to withdraw.
+		 * @return Applied, InsufficientFunds, InvalidAmount, or UnknownAccount.
+		 */
+		Account::TransactionResult withdraw(unsigned accountNumber, double amount);
+
+		/**
+		 * @brief Reads an account balance consistently with concurrent transactions.
+		 *
+		 * @param accountNumber Account to read.
+		 * @return Current balance, or 0 if the account does not exist.
+		 */
+		double getBalance(unsigned accountNumber);
+	};
+
+	/**
+	 * @brief Hammers a TransactionEngine from several threads and checks the totals.
+	 *
+	 * Runs on a private book in its own directory, inside a batch so the measured
+	 * throughput is the engine's rather than the journal's. Each worker applies random
+	 * deposits and withdrawals and counts the cents it moved; afterwards the bank
+	 * totals, the daily volume buckets and the sum of all balances must match those
+	 * counts exactly, both in memory and after the batch is ended and the book reloaded.
+	 *
+	 * @param threadCount Number of worker threads.
+	 * @param operationCount Total number of transactions across all workers.
+	 * @param directory Scratch directory for the data files; created if missing.
+	 * @return True if every total reconciled.
+	 */
+	bool runStressTest(unsigned threadCount, std::size_t operationCount, const std::string& directory);
+}
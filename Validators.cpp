@@ -1,5 +1,6 @@
 #include "Validators.h"
 #include "Account.h"
+#include "Metrics.h"
 #include "Storage.h"
 #include <iostream>
 #include <string>
@@ -101,7 +102,7 @@ namespace bankSimulation {
     /**
      * @brief Handles user login by matching last name and password.
      *
-     * Allows up to 3 attempts to find an account by last name.
+     * Allows up to 3 attempts to find an account by last name through the storage index.
      * If found, allows up to 3 attempts to enter the correct password.
      * Returns pointer to matched Account on success, nullptr on failure.
      *
@@ -115,10 +116,11 @@ namespace bankSimulation {
         while (securityCounter < 3 && !matchedAccount) {
             std::string lastName = stringValidator("Please enter your last name: ");
 
-            for (auto& acc : storage.getAccounts()) {
-                if (acc.getHolderLastName() == lastName) {
-                    matchedAccount = &acc;
-                    break;
+            {
+                ScopedTimer timer(Metric::LoginLookup);
+                const Storage::HandleList& matches = storage.findByLastName(storage.findLastNameId(lastName));
+                if (!matches.empty()) {
+                    matchedAccount = &storage.getAccount(matches.front());
                 }
             }
 
@@ -0,0 +1,274 @@
+#include "VolumeRollup.h"
+#include <algorithm>
+
+namespace bankSimulation {
+
+    const std::size_t VolumeRollup::minuteBuckets;
+    const std::size_t VolumeRollup::hourBuckets;
+    const std::size_t VolumeRollup::dayBuckets;
+
+    namespace {
+        /**
+         * @brief Divides and rounds toward negative infinity, so times before 1970 bucket correctly.
+         * @param value Dividend.
+         * @param divisor Positive divisor.
+         * @return Floor of value / divisor.
+         */
+        std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+            std::int64_t quotient = value / divisor;
+            return (value % divisor < 0) ? quotient - 1 : quotient;
+        }
+    }
+
+    /**
+     * @brief Creates empty minute, hour and day series.
+     */
+    VolumeRollup::VolumeRollup() {
+        series[static_cast<int>(Resolution::Minute)] = { 60, std::vector<Bucket>(minuteBuckets) };
+        series[static_cast<int>(Resolution::Hour)] = { 3'600, std::vector<Bucket>(hourBuckets) };
+        series[static_cast<int>(Resolution::Day)] = { 86'400, std::vector<Bucket>(dayBuckets) };
+    }
+
+    /**
+     * @brief Copies the buckets of another rollup while holding its lock.
+     * @param other Rollup to copy.
+     */
+    VolumeRollup::VolumeRollup(const VolumeRollup& other) {
+        std::lock_guard<std::mutex> lock(other.mutex);
+        for (int i = 0; i < 3; ++i) {
+            series[i] = other.series[i];
+        }
+    }
+
+    /**
+     * @brief Copies the buckets of another rollup, holding both locks.
+     * @param other Rollup to copy.
+     * @return Reference to this rollup.
+     */
+    VolumeRollup& VolumeRollup::operator=(const VolumeRollup& other) {
+        if (this != &other) {
+            std::scoped_lock lock(mutex, other.mutex);
+            for (int i = 0; i < 3; ++i) {
+                series[i] = other.series[i];
+            }
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Finds the bucket a time falls in.
+     *
+     * A slot holding an older bucket is cleared and reused. A slot already holding a
+     * newer bucket means the time is older than the whole ring, so there is nowhere to
+     * count it.
+     *
+     * @param target Series to look in.
+     * @param when Time in seconds since the epoch.
+     * @return The bucket, or nullptr if the time has fallen out of the ring.
+     */
+    VolumeRollup::Bucket* VolumeRollup::bucketFor(Series& target, std::int64_t when) {
+        std::int64_t index = floorDiv(when, target.width);
+        std::int64_t size = static_cast<std::int64_t>(target.ring.size());
+        Bucket& bucket = target.ring[static_cast<std::size_t>(((index % size) + size) % size)];
+
+        std::int64_t start = index * target.width;
+        if (bucket.start < start) {
+            bucket = Bucket();
+            bucket.start = start;
+        }
+        return bucket.start == start ? &bucket : nullptr;
+    }
+
+    /**
+     * @brief Adds a transaction to the bucket its time falls in at every resolution.
+     *
+     * @param when Time of the transaction.
+     * @param cents Amount in cents.
+     * @param deposit True for a deposit, false for a withdrawal.
+     */
+    void VolumeRollup::add(std::int64_t when, std::int64_t cents, bool deposit) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Series& target : series) {
+            Bucket* bucket = bucketFor(target, when);
+            if (bucket == nullptr) {
+                continue;
+            }
+            if (deposit) {
+                bucket->depositCents += cents;
+                ++bucket->deposits;
+            }
+            else {
+                bucket->withdrawalCents += cents;
+                ++bucket->withdrawals;
+            }
+        }
+    }
+
+    /**
+     * @brief Adds a deposit to the buckets its time falls in.
+     *
+     * @param cents Deposited amount in cents.
+     * @param when Time of the deposit.
+     */
+    void VolumeRollup::recordDeposit(std::int64_t cents, std::int64_t when) {
+        add(when, cents, true);
+    }
+
+    /**
+     * @brief Adds a withdrawal to the buckets its time falls in.
+     *
+     * @param cents Withdrawn amount in cents.
+     * @param when Time of the withdrawal.
+     */
+    void VolumeRollup::recordWithdrawal(std::int64_t cents, std::int64_t when) {
+        add(when, cents, false);
+    }
+
+    /**
+     * @brief Gets the most recent buckets of a series.
+     *
+     * Walks back from the bucket containing now. Slots that hold some other bucket, or
+     * none, are reported as empty buckets with the expected start.
+     *
+     * @param resolution Series to read.
+     * @param count Number of buckets; clamped to the ring size.
+     * @param now Time whose bucket is the newest one returned.
+     * @return Buckets oldest first.
+     */
+    std::vector<VolumeRollup::Bucket> VolumeRollup::recent(Resolution resolution, std::size_t count, std::int64_t now) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        const Series& source = series[static_cast<int>(resolution)];
+        std::int64_t size = static_cast<std::int64_t>(source.ring.size());
+        if (count > source.ring.size()) {
+            count = source.ring.size();
+        }
+
+        std::vector<Bucket> buckets(count);
+        std::int64_t newest = floorDiv(now, source.width);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::int64_t index = newest - static_cast<std::int64_t>(count - 1 - i);
+            const Bucket& slot = source.ring[static_cast<std::size_t>(((index % size) + size) % size)];
+            std::int64_t start = index * source.width;
+            if (slot.start == start) {
+                buckets[i] = slot;
+            }
+            buckets[i].start = start;
+        }
+        return buckets;
+    }
+
+    /**
+     * @brief Gets the width of the buckets at a resolution.
+     * @param resolution Series to describe.
+     * @return Seconds per bucket.
+     */
+    std::int64_t VolumeRollup::bucketWidth(Resolution resolution) const {
+        return series[static_cast<int>(resolution)].width;
+    }
+
+    /**
+     * @brief Gets how many buckets a series keeps.
+     * @param resolution Series to describe.
+     * @return Ring size.
+     */
+    std::size_t VolumeRollup::capacity(Resolution resolution) const {
+        return series[static_cast<int>(resolution)].ring.size();
+    }
+
+    /**
+     * @brief Writes every series in binary format.
+     *
+     * Each series is its bucket width and count followed by the used buckets, field by
+     * field. Unused slots are skipped, so a quiet bank writes almost nothing.
+     *
+     * @param out Output stream to write to.
+     */
+    void VolumeRollup::serialize(std::ostream& out) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::uint32_t seriesCount = 3;
+        out.write(reinterpret_cast<const char*>(&seriesCount), sizeof(seriesCount));
+
+        for (const Series& source : series) {
+            std::uint32_t used = 0;
+            for (const Bucket& bucket : source.ring) {
+                used += bucket.start != Bucket().start;
+            }
+            out.write(reinterpret_cast<const char*>(&source.width), sizeof(source.width));
+            out.write(reinterpret_cast<const char*>(&used), sizeof(used));
+
+            for (const Bucket& bucket : source.ring) {
+                if (bucket.start == Bucket().start) {
+                    continue;
+                }
+                out.write(reinterpret_cast<const char*>(&bucket.start), sizeof(bucket.start));
+                out.write(reinterpret_cast<const char*>(&bucket.depositCents), sizeof(bucket.depositCents));
+                out.write(reinterpret_cast<const char*>(&bucket.withdrawalCents), sizeof(bucket.withdrawalCents));
+                out.write(reinterpret_cast<const char*>(&bucket.deposits), sizeof(bucket.deposits));
+                out.write(reinterpret_cast<const char*>(&bucket.withdrawals), sizeof(bucket.withdrawals));
+            }
+        }
+    }
+
+    /**
+     * @brief Reads every series in binary format.
+     *
+     * Each stored bucket is added to the current series of the same width at its start
+     * time, so buckets land in the right slots whatever ring size wrote them.
+     *
+     * @param in Input stream to read from.
+     * @return False if the stream ended early.
+     */
+    bool VolumeRollup::deserialize(std::istream& in) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Series& target : series) {
+            std::fill(target.ring.begin(), target.ring.end(), Bucket());
+        }
+
+        std::uint32_t seriesCount = 0;
+        if (!in.read(reinterpret_cast<char*>(&seriesCount), sizeof(seriesCount))) {
+            return false;
+        }
+
+        for (std::uint32_t s = 0; s < seriesCount; ++s) {
+            std::int64_t width = 0;
+            std::uint32_t used = 0;
+            in.read(reinterpret_cast<char*>(&width), sizeof(width));
+            in.read(reinterpret_cast<char*>(&used), sizeof(used));
+            if (!in) {
+                break;
+            }
+
+            Series* target = nullptr;
+            for (Series& candidate : series) {
+                if (candidate.width == width) {
+                    target = &candidate;
+                }
+            }
+
+            for (std::uint32_t b = 0; b < used && in; ++b) {
+                Bucket stored;
+                in.read(reinterpret_cast<char*>(&stored.start), sizeof(stored.start));
+                in.read(reinterpret_cast<char*>(&stored.depositCents), sizeof(stored.depositCents));
+                in.read(reinterpret_cast<char*>(&stored.withdrawalCents), sizeof(stored.withdrawalCents));
+                in.read(reinterpret_cast<char*>(&stored.deposits), sizeof(stored.deposits));
+                in.read(reinterpret_cast<char*>(&stored.withdrawals), sizeof(stored.withdrawals));
+
+                Bucket* bucket = target != nullptr && in ? bucketFor(*target, stored.start) : nullptr;
+                if (bucket != nullptr) {
+                    bucket->depositCents += stored.depositCents;
+                    bucket->withdrawalCents += stored.withdrawalCents;
+                    bucket->deposits += stored.deposits;
+                    bucket->withdrawals += stored.withdrawals;
+                }
+            }
+        }
+
+        if (!in) {
+            for (Series& target : series) {
+                std::fill(target.ring.begin(), target.ring.end(), Bucket());
+            }
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+namespace bankSimulation {
+
+	/**
+	 * @class VolumeRollup
+	 * @brief Deposit and withdrawal volume per minute, hour and day, kept as it happens.
+	 *
+	 * Each resolution is a ring of fixed-width time buckets. A transaction adds to the
+	 * bucket its time falls in at every resolution, reusing the slot of the oldest bucket
+	 * once the ring wraps, so recording is O(1) and memory stays bounded. Reports read the
+	 * buckets directly and never touch account histories.
+	 *
+	 * Amounts are whole cents, like the BankFunds totals. Safe to update from several
+	 * threads; a single mutex guards the rings.
+	 */
+	class VolumeRollup {
+	public:
+		/**
+		 * @enum Resolution
+		 * @brief Width of the buckets in a series.
+		 */
+		enum class Resolution { Minute, Hour, Day };
+
+		/**
+		 * @struct Bucket
+		 * @brief Volume of one time bucket.
+		 */
+		struct Bucket {
+			std::int64_t start = std::numeric_limits<std::int64_t>::min();  ///< First second of the bucket; min() while unused
+			std::int64_t depositCents = 0;        ///< Total deposited
+			std::int64_t withdrawalCents = 0;     ///< Total withdrawn
+			std::uint32_t deposits = 0;           ///< Number of deposits
+			std::uint32_t withdrawals = 0;        ///< Number of withdrawals
+		};
+
+		static const std::size_t minuteBuckets = 120;   ///< Two hours of minutes
+		static const std::size_t hourBuckets = 168;     ///< A week of hours
+		static const std::size_t dayBuckets = 366;      ///< A year of days
+
+	private:
+		/**
+		 * @struct Series
+		 * @brief Ring of buckets at one resolution, slot = (time / width) mod size.
+		 */
+		struct Series {
+			std::int64_t width;                   ///< Seconds per bucket
+			std::vector<Bucket> ring;             ///< Buckets by slot
+		};
+
+		Series series[3];                         ///< Minute, hour and day series, by Resolution
+		mutable std::mutex mutex;                 ///< Guards every series
+
+		/**
+		 * @brief Finds the bucket a time falls in, claiming its slot if it holds an older bucket.
+		 * @return The bucket, or nullptr if the time is older than the whole ring.
+		 */
+		static Bucket* bucketFor(Series& target, std::int64_t when);
+
+		/**
+		 * @brief Adds a transaction to every series.
+		 */
+		void add(std::int64_t when, std::int64_t cents, bool deposit);
+
+	public:
+		/**
+		 * @brief Creates empty series at every resolution.
+		 */
+		VolumeRollup();
+
+		/**
+		 * @brief Copies the buckets of another rollup.
+		 * @param other Rollup to copy.
+		 */
+		VolumeRollup(const VolumeRollup& other);
+
+		/**
+		 * @brief Copies the buckets of another rollup.
+		 * @param other Rollup to copy.
+		 * @return Reference to this rollup.
+		 */
+		VolumeRollup& operator=(const VolumeRollup& other);
+
+		/**
+		 * @brief Adds a deposit to the buckets its time falls in.
+		 *
+		 * @param cents Deposited amount in cents.
+		 * @param when Time of the deposit, in seconds since the epoch.
+		 */
+		void recordDeposit(std::int64_t cents, std::int64_t when);
+
+		/**
+		 * @brief Adds a withdrawal to the buckets its time falls in.
+		 *
+		 * @param cents Withdrawn amount in cents.
+		 * @param when Time of the withdrawal, in seconds since the epoch.
+		 */
+		void recordWithdrawal(std::int64_t cents, std::int64_t when);
+
+		/**
+		 * @brief Gets the most recent buckets of a series, including empty ones.
+		 *
+		 * @param resolution Series to read.
+		 * @param count Number of buckets; at most the ring size of the series.
+		 * @param now Time whose bucket is the newest one returned.
+		 * @return Buckets oldest first, each with its start set.
+		 */
+		std::vector<Bucket> recent(Resolution resolution, std::size_t count, std::int64_t now) const;
+
+		/**
+		 * @brief Gets the width of the buckets at a resolution.
+		 * @param resolution Series to describe.
+		 * @return Seconds per bucket.
+		 */
+		std::int64_t bucketWidth(Resolution resolution) const;
+
+		/**
+		 * @brief Gets how many buckets a series keeps.
+		 * @param resolution Series to describe.
+		 * @return Ring size.
+		 */
+		std::size_t capacity(Resolution resolution) const;
+
+		/**
+		 * @brief Writes every series to a binary output stream.
+		 * @param out Output stream to write to.
+		 */
+		void serialize(std::ostream& out) const;
+
+		/**
+		 * @brief Replaces the buckets with ones read from a binary input stream.
+		 *
+		 * Stored buckets are added back by time, so a file written with other ring sizes
+		 * still loads; buckets too old for the current rings are dropped.
+		 *
+		 * @param in Input stream to read from.
+		 * @return False if the stream ended early; the rollup is left empty.
+		 */
+		bool deserialize(std::istream& in);
+	};
+}
@@ -1,6 +1,8 @@
 #include "menus.h"
 #include "Account.h"
+#include "Metrics.h"
 #include "Storage.h"
+#include "Trace.h"
 #include "Validators.h"
 #include <iostream>
 
@@ -10,8 +12,8 @@ namespace bankSimulation {
 	 * @brief Displays the interactive user menu for account operations.
 	 *
 	 * Allows authenticated users to perform standard banking actions such as depositing,
-	 * withdrawing, checking balances, and viewing transaction history. Changes are saved
-	 * on exit.
+	 * withdrawing, checking balances, and viewing transaction history in full, between
+	 * two dates, or only the most recent entries. Changes are saved on exit.
 	 *
 	 * @param storage Reference to the Storage object managing persistent data.
 	 * @param account Reference to the logged-in Account object.
@@ -25,9 +27,16 @@ namespace bankSimulation {
 			std::cout << "2. Withdraw funds" << std::endl;
 			std::cout << "3. Check account balance" << std::endl;
 			std::cout << "4. View transaction history" << std::endl;
-			std::cout << "5. Exit" << std::endl;
+			std::cout << "5. View transactions between two dates" << std::endl;
+			std::cout << "6. View recent transactions" << std::endl;
+			std::cout << "7. Exit" << std::endl;
 
-			switch (numericValidator("Your selection: ", 1, 5)) {
+			static const char* const actions[] = { "deposit", "withdrawal", "checkBalance", "viewHistory",
+				"viewHistoryBetween", "viewRecentHistory", "exitUserMenu" };
+			int selection = numericValidator("Your selection: ", 1, 7);
+			TraceScope trace(actions[selection - 1], "menu");
+
+			switch (selection) {
 			case 1:
 				account.deposit(bank, storage);
 				break;
@@ -38,11 +47,19 @@ namespace bankSimulation {
 				account.printAccountBalance();
 				break;
 			case 4:
+				storage.loadHistory(account);
 				account.printAccountHistory();
 				break;
 			case 5:
-				storage.saveAccount();
-				storage.saveBank();
+				storage.loadHistory(account);
+				account.printHistoryBetween();
+				break;
+			case 6:
+				storage.loadHistory(account);
+				account.printRecentHistory();
+				break;
+			case 7:
+				storage.checkpoint();
 				exit = true;
 				break;
 			default:
@@ -54,8 +71,10 @@ namespace bankSimulation {
 	/**
 	 * @brief Displays the employee menu for administrative banking tasks.
 	 *
-	 * Enables access to bank-level data operations, including generating bank reports
-	 * and searching user accounts. Saves data upon exiting the menu.
+	 * Enables access to bank-level data operations, including generating bank reports,
+	 * searching user accounts, running filtered account queries, viewing the balance
+	 * leaderboard and recent transaction volume, and viewing latency percentiles and
+	 * counters for the instrumented operations. Saves data upon exiting the menu.
 	 *
 	 * @param storage Reference to the Storage object managing all accounts and funds.
 	 */
@@ -65,9 +84,18 @@ namespace bankSimulation {
 			std::cout << std::endl << "Employee Menu" << std::endl;
 			std::cout << "1. Print bank report" << std::endl;
 			std::cout << "2. Search accounts" << std::endl;
-			std::cout << "3. Exit" << std::endl;
+			std::cout << "3. Query accounts" << std::endl;
+			std::cout << "4. Balance leaderboard" << std::endl;
+			std::cout << "5. Transaction volume report" << std::endl;
+			std::cout << "6. View performance metrics" << std::endl;
+			std::cout << "7. Exit" << std::endl;
+
+			static const char* const actions[] = { "bankReport", "searchAccounts", "queryAccounts",
+				"balanceLeaderboard", "volumeReport", "viewMetrics", "exitEmployeeMenu" };
+			int selection = numericValidator("Your selection: ", 1, 7);
+			TraceScope trace(actions[selection - 1], "menu");
 
-			switch (numericValidator("Your selection: ", 1, 3)) {
+			switch (selection) {
 			case 1:
 				if (!storage.getFunds().empty())
 					storage.getFunds()[0].printBankReport();
@@ -78,9 +106,23 @@ namespace bankSimulation {
 				storage.searchAccounts();
 				break;
 			case 3:
+				storage.queryAccounts();
+				break;
+			case 4:
+				storage.balanceLeaderboard();
+				break;
+			case 5:
+				if (!storage.getFunds().empty())
+					storage.getFunds()[0].printVolumeReport();
+				else
+					std::cout << "Bank fund data unavailable." << std::endl;
+				break;
+			case 6:
+				metrics::printReport(std::cout);
+				break;
+			case 7:
 				exit = true;
-				storage.saveAccount();
-				storage.saveBank();
+				storage.checkpoint();
 				break;
 			default:
 				std::cout << "Invalid selection." << std::endl;
@@ -106,7 +148,11 @@ namespace bankSimulation {
 			std::cout << "3. Log in as an employee" << std::endl;
 			std::cout << "4. Exit" << std::endl;
 
-			switch (numericValidator("Your selection: ", 1, 4)) {
+			static const char* const actions[] = { "newAccount", "userSession", "employeeSession", "exitBranchMenu" };
+			int selection = numericValidator("Your selection: ", 1, 4);
+			TraceScope trace(actions[selection - 1], "menu");
+
+			switch (selection) {
 			case 1:
 				storage.newAccount();
 				break;
@@ -139,8 +185,7 @@ namespace bankSimulation {
 				break;
 			case 4:
 				exit = true;
-				storage.saveAccount();
-				storage.saveBank();
+				storage.checkpoint();
 				break;
 			default:
 				std::cout << "Invalid selection." << std::endl;